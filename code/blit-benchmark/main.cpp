@@ -1,12 +1,18 @@
 #include <benchmark/benchmark.h>
 
+#include <chrono>
+#include <random>
+#include <vector>
+#include <utility>
 #include <algorithm>
 #include <cstring> // for std::memcpy
 
 #include <cassert>
 
+#include "../draw2d/cpu.hpp"
 #include "../draw2d/image.hpp"
 #include "../draw2d/surface.hpp"
+#include "../draw2d/surface-ops.hpp"
 
 namespace
 {
@@ -403,4 +409,534 @@ BENCHMARK(b_my_memcpy_calls_blit_)
 	->Args({ 7680, 4320 })
 ;
 
+namespace
+{
+	// Bulk surface operations (see surface-ops.hpp), with the different store
+	// variants. Bandwidth is reported as bytes written per second, for fills
+	// and copies alike. "vs_memcpy" relates this to a plain std::memcpy() of
+	// the same number of bytes (between two separate buffers), measured once
+	// per size.
+	enum class EBulkVariant_
+	{
+		automatic,
+		sse2,
+		sse2Stream,
+		avx2,
+		avx2Stream
+	};
+
+	void set_bulk_variant_( EBulkVariant_ aVariant )
+	{
+		bool const sse2 = EBulkVariant_::sse2 == aVariant || EBulkVariant_::sse2Stream == aVariant;
+		set_simd_level_limit( sse2 ? ESimdLevel::scalar : ESimdLevel::avx2 );
+
+		switch( aVariant )
+		{
+			case EBulkVariant_::automatic: set_store_mode( EStoreMode::automatic ); break;
+			case EBulkVariant_::sse2: [[fallthrough]];
+			case EBulkVariant_::avx2: set_store_mode( EStoreMode::regular ); break;
+			case EBulkVariant_::sse2Stream: [[fallthrough]];
+			case EBulkVariant_::avx2Stream: set_store_mode( EStoreMode::streaming ); break;
+		}
+	}
+
+	double memcpy_bandwidth_( std::size_t aBytes )
+	{
+		std::vector<std::uint8_t> src( aBytes, 1 ), dst( aBytes, 0 );
+
+		using Clock_ = std::chrono::steady_clock;
+
+		std::size_t reps = 0;
+		auto const start = Clock_::now();
+		auto now = start;
+		do
+		{
+			std::memcpy( dst.data(), src.data(), aBytes );
+			benchmark::ClobberMemory();
+			++reps;
+			now = Clock_::now();
+		} while( now - start < std::chrono::milliseconds( 200 ) );
+
+		return double(aBytes) * double(reps) / std::chrono::duration<double>( now - start ).count();
+	}
+
+	template< typename tOp >
+	void run_bulk_( benchmark::State& aState, std::size_t aBytes, tOp&& aOp )
+	{
+		using Clock_ = std::chrono::steady_clock;
+
+		auto const start = Clock_::now();
+		for( auto _ : aState )
+		{
+			aOp();
+			benchmark::ClobberMemory();
+		}
+		auto const elapsed = std::chrono::duration<double>( Clock_::now() - start ).count();
+
+		set_bulk_variant_( EBulkVariant_::automatic );
+
+		aState.SetBytesProcessed( std::int64_t(aBytes) * aState.iterations() );
+
+		auto const bandwidth = double(aBytes) * double(aState.iterations()) / elapsed;
+		aState.counters["vs_memcpy"] = bandwidth / memcpy_bandwidth_( aBytes );
+	}
+
+	void c_memcpy_( benchmark::State& aState )
+	{
+		auto const bytes = std::size_t(aState.range(0)) * std::size_t(aState.range(1)) * 4;
+		std::vector<std::uint8_t> src( bytes, 1 ), dst( bytes, 0 );
+
+		for( auto _ : aState )
+		{
+			std::memcpy( dst.data(), src.data(), bytes );
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetBytesProcessed( std::int64_t(bytes) * aState.iterations() );
+	}
+
+	void c_surface_fill_( benchmark::State& aState, EBulkVariant_ aVariant )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		Surface surface( width, height );
+		surface.clear();
+
+		set_bulk_variant_( aVariant );
+		run_bulk_( aState, std::size_t(width)*height*4, [&] {
+			surface.fill( { 32, 64, 128 } );
+		} );
+	}
+
+	// Reference: the original Surface::fill(), one byte at a time
+	void c_surface_fill_bytewise_( benchmark::State& aState )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		Surface surface( width, height );
+		surface.clear();
+
+		run_bulk_( aState, std::size_t(width)*height*4, [&] {
+			for( std::uint32_t y = 0; y < height; ++y )
+			{
+				auto* ptr = surface.get_surface_ptr() + surface.get_linear_index( 0, y );
+				for( std::size_t i = 0; i < std::size_t(width) * 4; i += 4 )
+				{
+					ptr[i+0] = 32;
+					ptr[i+1] = 64;
+					ptr[i+2] = 128;
+					ptr[i+3] = 0;
+				}
+			}
+		} );
+	}
+
+	// A block of half the surface's width and height
+	void c_fill_rect_( benchmark::State& aState, EBulkVariant_ aVariant )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		Surface surface( width, height );
+		surface.clear();
+
+		PixelRect const rect{ int(width/4), int(height/4), int(width/4 + width/2), int(height/4 + height/2) };
+
+		set_bulk_variant_( aVariant );
+		run_bulk_( aState, std::size_t(width/2)*(height/2)*4, [&] {
+			fill_rect( surface, rect, { 255, 0, 0 } );
+		} );
+	}
+
+	// Whole surface, to a second surface (offset by one pixel, so that the
+	// rows are not equally aligned)
+	void c_copy_rect_( benchmark::State& aState, EBulkVariant_ aVariant )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		Surface source( width, height );
+		source.fill( { 1, 2, 3 } );
+
+		Surface dest( width+1, height );
+		dest.clear();
+
+		PixelRect const rect{ 0, 0, int(width), int(height) };
+
+		set_bulk_variant_( aVariant );
+		run_bulk_( aState, std::size_t(width)*height*4, [&] {
+			copy_rect( dest, 1, 0, source, rect );
+		} );
+	}
+
+	// Surfaces with heap storage or backed by huge pages. The label shows
+	// what the surfaces actually got (see ESurfaceStorage). Fills and blits
+	// stream through the whole surface; the tile column touches a different
+	// (4 KiB) page in every row, like clearing a dirty tile.
+	enum class EPageOp_
+	{
+		fill,
+		blit,
+		column
+	};
+
+	void h_huge_pages_( benchmark::State& aState, EPageOp_ aOp, bool aHugePages )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		set_surface_huge_pages( aHugePages );
+
+		Surface source( width, height );
+		source.fill( { 1, 2, 3 } );
+
+		Surface dest( width, height );
+		dest.clear();
+
+		set_surface_huge_pages( false );
+
+		aState.SetLabel( to_string( dest.get_storage() ) );
+
+		PixelRect const full{ 0, 0, int(width), int(height) };
+		PixelRect const column{ 0, 0, int(Surface::kDirtyTileSize), int(height) };
+
+		switch( aOp )
+		{
+			case EPageOp_::fill:
+				run_bulk_( aState, std::size_t(width)*height*4, [&] {
+					dest.fill( { 32, 64, 128 } );
+				} );
+				break;
+			case EPageOp_::blit:
+				run_bulk_( aState, std::size_t(width)*height*4, [&] {
+					copy_rect( dest, 0, 0, source, full );
+				} );
+				break;
+			case EPageOp_::column:
+				run_bulk_( aState, std::size_t(Surface::kDirtyTileSize)*height*4, [&] {
+					fill_rect( dest, column, { 255, 0, 0 } );
+				} );
+				break;
+		}
+	}
+}
+
+namespace
+{
+	// Masked blit of the earth image, either one pixel at a time with
+	// Surface::set_pixel_srgb() (like the original blit_masked()), or with
+	// blit_masked(), which writes spans of opaque pixels.
+	enum class EWriteMode_
+	{
+		perPixel,
+		span
+	};
+
+	void blit_per_pixel_( Surface& aSurface, ImageRGBA const& aImage, Vec2f aPosition )
+	{
+		for( ImageRGBA::Index y = 0; y < aImage.get_height(); ++y )
+		{
+			for( ImageRGBA::Index x = 0; x < aImage.get_width(); ++x )
+			{
+				auto const pixel = aImage.get_pixel( x, y );
+				if( pixel.a < 128 )
+					continue;
+
+				float const dx = aPosition.x + float(x);
+				float const dy = aPosition.y + float(y);
+				if( dx >= 0.f && dx < float(aSurface.get_width()) && dy >= 0.f && dy < float(aSurface.get_height()) )
+					aSurface.set_pixel_srgb( Surface::Index(dx), Surface::Index(dy), { pixel.r, pixel.g, pixel.b } );
+			}
+		}
+	}
+
+	void d_blit_writes_( benchmark::State& aState, EWriteMode_ aMode )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		Surface surface( width, height );
+		surface.clear();
+
+		auto source = load_image( "assets/earth.png" );
+		assert( source );
+
+		for( auto _ : aState )
+		{
+			if( EWriteMode_::span == aMode )
+				blit_masked( surface, *source, { 0.f, 0.f } );
+			else
+				blit_per_pixel_( surface, *source, { 0.f, 0.f } );
+
+			benchmark::ClobberMemory();
+		}
+
+		auto const maxBlitX = std::min( width, source->get_width() );
+		auto const maxBlitY = std::min( height, source->get_height() );
+
+		aState.SetBytesProcessed( 2*maxBlitX*maxBlitY*4 * aState.iterations() );
+	}
+}
+
+BENCHMARK_CAPTURE(d_blit_writes_, per_pixel, EWriteMode_::perPixel)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(d_blit_writes_, span, EWriteMode_::span)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+
+namespace
+{
+	// One frame: aState.range(2) sprites (64x64 blocks) are drawn, and the
+	// surface is cleared again, either entirely (like the original
+	// Surface::clear()), or only where something was drawn (clear()). The
+	// counters give the bytes cleared and the bytes that a presenter would
+	// upload (dirty tiles) per frame.
+	enum class EFrameClear_
+	{
+		full,
+		dirty
+	};
+
+	void e_frame_clear_( benchmark::State& aState, EFrameClear_ aMode )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+		auto const sprites = std::size_t(aState.range(2));
+
+		Surface surface( width, height );
+		surface.clear();
+
+		std::minstd_rand rng( 7 );
+		std::uniform_int_distribution<int> xdist( -32, int(width) );
+		std::uniform_int_distribution<int> ydist( -32, int(height) );
+
+		std::vector<PixelRect> positions;
+		for( std::size_t i = 0; i < sprites; ++i )
+		{
+			int const x = xdist( rng ), y = ydist( rng );
+			positions.emplace_back( PixelRect{ x, y, x+64, y+64 } );
+		}
+
+		std::vector<PixelRect> dirty;
+		std::size_t cleared = 0, uploaded = 0;
+		for( auto _ : aState )
+		{
+			for( auto const& rect : positions )
+				fill_rect( surface, rect, { 255, 255, 255 } );
+
+			dirty.clear();
+			surface.get_dirty_rects( dirty );
+			for( auto const& rect : dirty )
+				uploaded += std::size_t(rect.x1-rect.x0) * std::size_t(rect.y1-rect.y0) * 4;
+			surface.clear_dirty();
+
+			if( EFrameClear_::full == aMode )
+			{
+				surface.fill( { 0, 0, 0 } );
+				cleared += std::size_t(width) * height * 4;
+			}
+			else
+			{
+				surface.clear();
+				cleared += surface.get_cleared_bytes();
+			}
+
+			benchmark::ClobberMemory();
+		}
+
+		aState.counters["cleared"] = benchmark::Counter( double(cleared), benchmark::Counter::kAvgIterations, benchmark::Counter::kIs1024 );
+		aState.counters["uploaded"] = benchmark::Counter( double(uploaded), benchmark::Counter::kAvgIterations, benchmark::Counter::kIs1024 );
+	}
+
+	// Resize events of an interactive window resize: the window shrinks to
+	// half its size and grows back, a few pixels per event. Either a new
+	// surface is created for each event (like main.cpp used to do), or the
+	// surface is resized in place.
+	enum class EResize_
+	{
+		recreate,
+		resize
+	};
+
+	void f_resize_drag_( benchmark::State& aState, EResize_ aMode )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+		auto const steps = std::uint32_t(aState.range(2));
+
+		std::vector<std::pair<std::uint32_t,std::uint32_t>> sizes;
+		for( std::uint32_t i = 0; i <= steps; ++i )
+			sizes.emplace_back( width - width/2*i/steps, height - height/2*i/steps );
+		for( std::uint32_t i = steps; i-- > 0; )
+			sizes.emplace_back( sizes[i] );
+
+		Surface surface( width, height );
+
+		reset_surface_alloc_stats();
+		for( auto _ : aState )
+		{
+			for( auto const& [w, h] : sizes )
+			{
+				if( EResize_::recreate == aMode )
+					surface = Surface( w, h );
+				else
+					surface.resize( w, h );
+
+				benchmark::ClobberMemory();
+			}
+		}
+
+		auto const stats = surface_alloc_stats();
+		aState.counters["events"] = benchmark::Counter( double(sizes.size()), benchmark::Counter::kIsIterationInvariantRate );
+		aState.counters["allocs"] = benchmark::Counter( double(stats.allocations), benchmark::Counter::kAvgIterations );
+		aState.counters["allocated"] = benchmark::Counter( double(stats.bytesAllocated), benchmark::Counter::kAvgIterations, benchmark::Counter::kIs1024 );
+	}
+}
+
+BENCHMARK_CAPTURE(e_frame_clear_, full, EFrameClear_::full)
+	->Args({ 1920, 1080, 16 })
+	->Args({ 1920, 1080, 256 })
+	->Args({ 7680, 4320, 16 })
+	->Args({ 7680, 4320, 256 })
+;
+BENCHMARK_CAPTURE(e_frame_clear_, dirty, EFrameClear_::dirty)
+	->Args({ 1920, 1080, 16 })
+	->Args({ 1920, 1080, 256 })
+	->Args({ 7680, 4320, 16 })
+	->Args({ 7680, 4320, 256 })
+;
+
+BENCHMARK_CAPTURE(f_resize_drag_, recreate, EResize_::recreate)
+	->Args({ 1920, 1080, 32 })
+	->Args({ 7680, 4320, 32 })
+	->Unit(benchmark::kMillisecond)
+;
+BENCHMARK_CAPTURE(f_resize_drag_, resize, EResize_::resize)
+	->Args({ 1920, 1080, 32 })
+	->Args({ 7680, 4320, 32 })
+	->Unit(benchmark::kMillisecond)
+;
+
+BENCHMARK_CAPTURE(h_huge_pages_, fill_heap, EPageOp_::fill, false)
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(h_huge_pages_, fill_huge, EPageOp_::fill, true)
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(h_huge_pages_, blit_heap, EPageOp_::blit, false)
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(h_huge_pages_, blit_huge, EPageOp_::blit, true)
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(h_huge_pages_, column_heap, EPageOp_::column, false)
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(h_huge_pages_, column_huge, EPageOp_::column, true)
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+
+BENCHMARK(c_memcpy_)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+
+BENCHMARK(c_surface_fill_bytewise_)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+
+BENCHMARK_CAPTURE(c_surface_fill_, automatic, EBulkVariant_::automatic)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(c_surface_fill_, sse2, EBulkVariant_::sse2)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(c_surface_fill_, sse2_stream, EBulkVariant_::sse2Stream)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(c_surface_fill_, avx2, EBulkVariant_::avx2)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(c_surface_fill_, avx2_stream, EBulkVariant_::avx2Stream)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+
+BENCHMARK_CAPTURE(c_fill_rect_, automatic, EBulkVariant_::automatic)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(c_fill_rect_, sse2, EBulkVariant_::sse2)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(c_fill_rect_, sse2_stream, EBulkVariant_::sse2Stream)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(c_fill_rect_, avx2, EBulkVariant_::avx2)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(c_fill_rect_, avx2_stream, EBulkVariant_::avx2Stream)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+
+BENCHMARK_CAPTURE(c_copy_rect_, automatic, EBulkVariant_::automatic)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(c_copy_rect_, sse2, EBulkVariant_::sse2)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(c_copy_rect_, sse2_stream, EBulkVariant_::sse2Stream)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(c_copy_rect_, avx2, EBulkVariant_::avx2)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(c_copy_rect_, avx2_stream, EBulkVariant_::avx2Stream)
+	->Args({ 320, 240 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+
 BENCHMARK_MAIN();
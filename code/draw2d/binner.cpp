@@ -0,0 +1,245 @@
+#include "binner.hpp"
+
+#include <algorithm>
+
+#include <cmath>
+#include <cassert>
+
+#include "color.hpp"
+#include "surface.hpp"
+#include "triangle-kernels.hpp"
+
+struct TriangleBinner::Triangle_
+{
+	Vec2f p[3];
+	bool interp;
+	ColorU8_sRGB color; // solid
+	ColorPlane planes[3]; // interp
+};
+
+namespace
+{
+	// Clamps the tile index of a coordinate to [0,aCount). Written such that
+	// NaN ends up as zero.
+	int tile_index_( float aCoord, int aTileSize, int aCount ) noexcept;
+}
+
+TriangleBinner::TriangleBinner( std::size_t aThreadCount, int aTileSize )
+	: mTileSize( aTileSize )
+	, mTilesX( 0 )
+	, mTilesY( 0 )
+	, mTarget( nullptr )
+	, mNextTile( 0 )
+	, mGeneration( 0 )
+	, mBusy( 0 )
+	, mQuit( false )
+{
+	assert( aTileSize > 0 );
+
+	if( 0 == aThreadCount )
+		aThreadCount = std::max( 1u, std::thread::hardware_concurrency() );
+
+	mWorkers.reserve( aThreadCount-1 );
+	for( std::size_t i = 1; i < aThreadCount; ++i )
+		mWorkers.emplace_back( [this] { worker_(); } );
+}
+
+TriangleBinner::~TriangleBinner()
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mQuit = true;
+	}
+
+	mWake.notify_all();
+	for( auto& worker : mWorkers )
+		worker.join();
+}
+
+void TriangleBinner::draw_triangle_solid( Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorU8_sRGB aColor )
+{
+	Triangle_ tri{};
+	tri.p[0] = aP0;
+	tri.p[1] = aP1;
+	tri.p[2] = aP2;
+	tri.interp = false;
+	tri.color = aColor;
+
+	mTriangles.emplace_back( tri );
+}
+
+void TriangleBinner::draw_triangle_interp( Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorF aC0, ColorF aC1, ColorF aC2 )
+{
+	// Same as ::draw_triangle_interp(): uniform triangles are filled.
+	ColorU8_sRGB uniform;
+	if( uniform_color( aC0, aC1, aC2, uniform ) )
+	{
+		draw_triangle_solid( aP0, aP1, aP2, uniform );
+		return;
+	}
+
+	Triangle_ tri{};
+	if( !make_color_planes( tri.planes, aP0, aP1, aP2, aC0, aC1, aC2 ) )
+		return;
+
+	tri.p[0] = aP0;
+	tri.p[1] = aP1;
+	tri.p[2] = aP2;
+	tri.interp = true;
+
+	mTriangles.emplace_back( tri );
+}
+
+void TriangleBinner::flush( Surface& aSurface )
+{
+	assert( mTriangles.size() <= 0xffffffffu );
+
+	// Bin by bounding box. This is conservative: a triangle may end up in a
+	// tile that it does not cover, in which case the rasterizer produces no
+	// spans for it there.
+	auto const width = int(aSurface.get_width());
+	auto const height = int(aSurface.get_height());
+
+	mTilesX = (width + mTileSize-1) / mTileSize;
+	mTilesY = (height + mTileSize-1) / mTileSize;
+
+	mBins.resize( std::size_t(mTilesX)*mTilesY );
+	for( auto& bin : mBins )
+		bin.clear();
+
+	for( std::size_t i = 0; i < mTriangles.size(); ++i )
+	{
+		auto const& tri = mTriangles[i];
+
+		auto const minX = std::min( { tri.p[0].x, tri.p[1].x, tri.p[2].x } );
+		auto const maxX = std::max( { tri.p[0].x, tri.p[1].x, tri.p[2].x } );
+		auto const minY = std::min( { tri.p[0].y, tri.p[1].y, tri.p[2].y } );
+		auto const maxY = std::max( { tri.p[0].y, tri.p[1].y, tri.p[2].y } );
+
+		if( maxX < 0.f || maxY < 0.f || minX >= float(width) || minY >= float(height) )
+			continue;
+
+		int const tx0 = tile_index_( minX, mTileSize, mTilesX );
+		int const tx1 = tile_index_( maxX, mTileSize, mTilesX );
+		int const ty0 = tile_index_( minY, mTileSize, mTilesY );
+		int const ty1 = tile_index_( maxY, mTileSize, mTilesY );
+
+		for( int ty = ty0; ty <= ty1; ++ty )
+		{
+			for( int tx = tx0; tx <= tx1; ++tx )
+				mBins[std::size_t(ty)*mTilesX + tx].emplace_back( std::uint32_t(i) );
+		}
+	}
+
+	mActiveTiles.clear();
+	for( std::size_t i = 0; i < mBins.size(); ++i )
+	{
+		if( !mBins[i].empty() )
+			mActiveTiles.emplace_back( std::uint32_t(i) );
+	}
+
+	// Rasterize. The calling thread helps out.
+	mTarget = &aSurface;
+	mNextTile.store( 0, std::memory_order_relaxed );
+
+	if( !mWorkers.empty() )
+	{
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			++mGeneration;
+			mBusy = mWorkers.size();
+		}
+		mWake.notify_all();
+	}
+
+	run_tiles_();
+
+	if( !mWorkers.empty() )
+	{
+		std::unique_lock<std::mutex> lock( mMutex );
+		mDone.wait( lock, [this] { return 0 == mBusy; } );
+	}
+
+	mTarget = nullptr;
+	mTriangles.clear();
+}
+
+std::size_t TriangleBinner::thread_count() const noexcept
+{
+	return mWorkers.size() + 1;
+}
+std::size_t TriangleBinner::pending_count() const noexcept
+{
+	return mTriangles.size();
+}
+
+void TriangleBinner::worker_()
+{
+	std::uint64_t seen = 0;
+	for( ;; )
+	{
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+			mWake.wait( lock, [&] { return mQuit || mGeneration != seen; } );
+
+			if( mQuit )
+				return;
+
+			seen = mGeneration;
+		}
+
+		run_tiles_();
+
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			if( 0 == --mBusy )
+				mDone.notify_one();
+		}
+	}
+}
+
+void TriangleBinner::run_tiles_()
+{
+	assert( mTarget );
+	auto& surface = *mTarget;
+
+	auto const width = int(surface.get_width());
+	auto const height = int(surface.get_height());
+
+	for( ;; )
+	{
+		auto const next = mNextTile.fetch_add( 1, std::memory_order_relaxed );
+		if( next >= mActiveTiles.size() )
+			return;
+
+		auto const tile = mActiveTiles[next];
+		int const tx = int(tile % std::uint32_t(mTilesX));
+		int const ty = int(tile / std::uint32_t(mTilesX));
+
+		PixelRect const clip{
+			tx*mTileSize, ty*mTileSize,
+			std::min( (tx+1)*mTileSize, width ), std::min( (ty+1)*mTileSize, height )
+		};
+
+		for( auto const index : mBins[tile] )
+		{
+			auto const& tri = mTriangles[index];
+			if( tri.interp )
+				rasterize_triangle_interp( surface, clip, tri.p[0], tri.p[1], tri.p[2], tri.planes );
+			else
+				rasterize_triangle_solid( surface, clip, tri.p[0], tri.p[1], tri.p[2], tri.color );
+		}
+	}
+}
+
+namespace
+{
+	int tile_index_( float aCoord, int aTileSize, int aCount ) noexcept
+	{
+		float const index = std::floor( aCoord / float(aTileSize) );
+		if( !(index > 0.f) )
+			return 0;
+
+		return index < float(aCount-1) ? int(index) : aCount-1;
+	}
+}
@@ -0,0 +1,77 @@
+#ifndef BINNER_HPP_9E3A5C27_61D4_4B8F_A0C2_5D7F1E84B36A
+#define BINNER_HPP_9E3A5C27_61D4_4B8F_A0C2_5D7F1E84B36A
+
+// Tile-binned, multithreaded triangle rasterization
+//
+// Triangles submitted to a TriangleBinner are only recorded. flush() sorts
+// them into the screen tiles that they overlap, and then rasterizes the tiles
+// in parallel. Each tile is owned by exactly one thread at a time, so the
+// threads never write the same pixels and need no locking on the Surface.
+// Within a tile, triangles are drawn in submission order. The result is
+// identical to drawing the triangles one by one with draw_triangle_solid() and
+// draw_triangle_interp().
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "forward.hpp"
+
+#include "../vmlib/vec2.hpp"
+
+class TriangleBinner final
+{
+	public:
+		// aThreadCount is the total number of threads that rasterize,
+		// including the one calling flush(). Zero means one per hardware
+		// thread.
+		explicit TriangleBinner( std::size_t aThreadCount = 0, int aTileSize = 64 );
+		~TriangleBinner();
+
+		TriangleBinner( TriangleBinner const& ) = delete;
+		TriangleBinner& operator= (TriangleBinner const&) = delete;
+
+	public:
+		// Same arguments as the corresponding functions in draw.hpp.
+		void draw_triangle_solid( Vec2f, Vec2f, Vec2f, ColorU8_sRGB );
+		void draw_triangle_interp( Vec2f, Vec2f, Vec2f, ColorF, ColorF, ColorF );
+
+		// Draws all triangles submitted since the last flush onto the
+		// surface. Returns when all of them are drawn.
+		void flush( Surface& );
+
+		std::size_t thread_count() const noexcept;
+		std::size_t pending_count() const noexcept;
+
+	private:
+		void worker_();
+		void run_tiles_();
+
+	private:
+		struct Triangle_; // see binner.cpp
+
+		int mTileSize;
+		int mTilesX, mTilesY;
+
+		std::vector<Triangle_> mTriangles;
+		std::vector<std::vector<std::uint32_t>> mBins; // triangle indices per tile
+		std::vector<std::uint32_t> mActiveTiles;
+
+		Surface* mTarget;
+		std::atomic<std::size_t> mNextTile;
+
+		std::vector<std::thread> mWorkers;
+
+		std::mutex mMutex;
+		std::condition_variable mWake, mDone;
+		std::uint64_t mGeneration;
+		std::size_t mBusy;
+		bool mQuit;
+};
+
+#endif // BINNER_HPP_9E3A5C27_61D4_4B8F_A0C2_5D7F1E84B36A
@@ -0,0 +1,93 @@
+#include "block-kernels.hpp"
+
+#include "cpu.hpp"
+
+#if DRAW2D_X86
+
+#include <cassert>
+
+#include <immintrin.h>
+
+DRAW2D_TARGET_AVX2
+void fill_rows_avx2( std::uint32_t* aFirst, std::ptrdiff_t aPitch, int aWidth, int aHeight, std::uint32_t aPixel, bool aStream ) noexcept
+{
+	assert( aFirst || 0 == aWidth || 0 == aHeight );
+
+	auto const value = _mm256_set1_epi32( int(aPixel) );
+
+	for( int y = 0; y < aHeight; ++y )
+	{
+		std::uint32_t* ptr = aFirst + y*aPitch;
+		std::uint32_t* const end = ptr + aWidth;
+
+		// Pixels up to the first 32 byte boundary, then full (aligned) 32
+		// byte blocks, then the remaining pixels. Pixels are 4-aligned, so
+		// the head is at most seven pixels.
+		while( ptr != end && 0 != (reinterpret_cast<std::uintptr_t>(ptr) & 31) )
+			*ptr++ = aPixel;
+
+		std::uint32_t* const blockEnd = ptr + ((end - ptr) & ~std::ptrdiff_t(7));
+		if( aStream )
+		{
+			for( ; ptr != blockEnd; ptr += 8 )
+				_mm256_stream_si256( reinterpret_cast<__m256i*>(ptr), value );
+		}
+		else
+		{
+			for( ; ptr != blockEnd; ptr += 8 )
+				_mm256_store_si256( reinterpret_cast<__m256i*>(ptr), value );
+		}
+
+		while( ptr != end )
+			*ptr++ = aPixel;
+	}
+
+	// Streaming stores are weakly ordered; make them visible before any
+	// later stores (e.g., of another thread that reads the surface).
+	if( aStream )
+		_mm_sfence();
+}
+
+DRAW2D_TARGET_AVX2
+void copy_rows_avx2( std::uint32_t* aDst, std::ptrdiff_t aDstPitch, std::uint32_t const* aSrc, std::ptrdiff_t aSrcPitch, int aWidth, int aHeight, bool aStream ) noexcept
+{
+	assert( (aDst && aSrc) || 0 == aWidth || 0 == aHeight );
+
+	for( int y = 0; y < aHeight; ++y )
+	{
+		std::uint32_t* dst = aDst + y*aDstPitch;
+		std::uint32_t const* src = aSrc + y*aSrcPitch;
+		std::uint32_t* const end = dst + aWidth;
+
+		// As above, aligned to the destination. The source is generally at a
+		// different alignment, and is loaded with unaligned loads.
+		while( dst != end && 0 != (reinterpret_cast<std::uintptr_t>(dst) & 31) )
+			*dst++ = *src++;
+
+		std::uint32_t* const blockEnd = dst + ((end - dst) & ~std::ptrdiff_t(7));
+		if( aStream )
+		{
+			for( ; dst != blockEnd; dst += 8, src += 8 )
+			{
+				auto const value = _mm256_loadu_si256( reinterpret_cast<__m256i const*>(src) );
+				_mm256_stream_si256( reinterpret_cast<__m256i*>(dst), value );
+			}
+		}
+		else
+		{
+			for( ; dst != blockEnd; dst += 8, src += 8 )
+			{
+				auto const value = _mm256_loadu_si256( reinterpret_cast<__m256i const*>(src) );
+				_mm256_store_si256( reinterpret_cast<__m256i*>(dst), value );
+			}
+		}
+
+		while( dst != end )
+			*dst++ = *src++;
+	}
+
+	if( aStream )
+		_mm_sfence();
+}
+
+#endif // ~ DRAW2D_X86
@@ -0,0 +1,165 @@
+#include "block-kernels.hpp"
+
+#include <algorithm>
+
+#include <cassert>
+#include <cstring>
+
+#include "cpu.hpp"
+#include "surface-ops.hpp"
+
+#if DRAW2D_X86
+#	include <emmintrin.h>
+#endif
+
+namespace
+{
+	constexpr int kMinWidthAvx2 = 16;
+
+	bool stream_block_( int aWidth, int aHeight ) noexcept;
+	bool use_avx2_( int aWidth ) noexcept;
+
+	void fill_rows_baseline_( std::uint32_t*, std::ptrdiff_t aPitch, int aWidth, int aHeight, std::uint32_t aPixel, bool aStream ) noexcept;
+	void copy_rows_baseline_( std::uint32_t*, std::ptrdiff_t aDstPitch, std::uint32_t const*, std::ptrdiff_t aSrcPitch, int aWidth, int aHeight, bool aStream ) noexcept;
+}
+
+void fill_rows( std::uint32_t* aFirst, std::ptrdiff_t aPitch, int aWidth, int aHeight, std::uint32_t aPixel ) noexcept
+{
+	if( aWidth <= 0 || aHeight <= 0 )
+		return;
+
+	assert( aFirst );
+
+	bool const stream = stream_block_( aWidth, aHeight );
+
+#	if DRAW2D_X86
+	if( use_avx2_( aWidth ) )
+	{
+		fill_rows_avx2( aFirst, aPitch, aWidth, aHeight, aPixel, stream );
+		return;
+	}
+#	endif // ~ DRAW2D_X86
+
+	fill_rows_baseline_( aFirst, aPitch, aWidth, aHeight, aPixel, stream );
+}
+
+void copy_rows( std::uint32_t* aDst, std::ptrdiff_t aDstPitch, std::uint32_t const* aSrc, std::ptrdiff_t aSrcPitch, int aWidth, int aHeight ) noexcept
+{
+	if( aWidth <= 0 || aHeight <= 0 )
+		return;
+
+	assert( aDst && aSrc );
+
+	bool const stream = stream_block_( aWidth, aHeight );
+
+#	if DRAW2D_X86
+	if( use_avx2_( aWidth ) )
+	{
+		copy_rows_avx2( aDst, aDstPitch, aSrc, aSrcPitch, aWidth, aHeight, stream );
+		return;
+	}
+#	endif // ~ DRAW2D_X86
+
+	copy_rows_baseline_( aDst, aDstPitch, aSrc, aSrcPitch, aWidth, aHeight, stream );
+}
+
+namespace
+{
+	bool stream_block_( int aWidth, int aHeight ) noexcept
+	{
+		switch( store_mode() )
+		{
+			case EStoreMode::regular: return false;
+			case EStoreMode::streaming: return true;
+			case EStoreMode::automatic: break;
+		}
+
+		return std::size_t(aWidth) * std::size_t(aHeight) * sizeof(std::uint32_t) >= kStreamBlockBytes;
+	}
+
+	bool use_avx2_( int aWidth ) noexcept
+	{
+		// Narrow rows are mostly head and tail; the baseline code is as fast
+		// for those.
+		return aWidth >= kMinWidthAvx2 && ESimdLevel::avx2 == simd_level();
+	}
+
+	// SSE2 is part of the x64 baseline, so 16-byte stores (streaming or not)
+	// are always available there. Otherwise, fills use std::fill_n(). Copies
+	// with regular stores use std::memcpy(), which the C library already
+	// implements with the widest stores available.
+	void fill_rows_baseline_( std::uint32_t* aFirst, std::ptrdiff_t aPitch, int aWidth, int aHeight, std::uint32_t aPixel, bool aStream ) noexcept
+	{
+#		if DRAW2D_X86
+		auto const value = _mm_set1_epi32( int(aPixel) );
+
+		for( int y = 0; y < aHeight; ++y )
+		{
+			std::uint32_t* ptr = aFirst + y*aPitch;
+			std::uint32_t* const end = ptr + aWidth;
+
+			while( ptr != end && 0 != (reinterpret_cast<std::uintptr_t>(ptr) & 15) )
+				*ptr++ = aPixel;
+
+			std::uint32_t* const blockEnd = ptr + ((end - ptr) & ~std::ptrdiff_t(3));
+			if( aStream )
+			{
+				for( ; ptr != blockEnd; ptr += 4 )
+					_mm_stream_si128( reinterpret_cast<__m128i*>(ptr), value );
+			}
+			else
+			{
+				for( ; ptr != blockEnd; ptr += 4 )
+					_mm_store_si128( reinterpret_cast<__m128i*>(ptr), value );
+			}
+
+			while( ptr != end )
+				*ptr++ = aPixel;
+		}
+
+		if( aStream )
+			_mm_sfence();
+#		else // !DRAW2D_X86
+		(void)aStream;
+
+		for( int y = 0; y < aHeight; ++y )
+			std::fill_n( aFirst + y*aPitch, aWidth, aPixel );
+#		endif // ~ DRAW2D_X86
+	}
+
+	void copy_rows_baseline_( std::uint32_t* aDst, std::ptrdiff_t aDstPitch, std::uint32_t const* aSrc, std::ptrdiff_t aSrcPitch, int aWidth, int aHeight, bool aStream ) noexcept
+	{
+#		if DRAW2D_X86
+		if( aStream )
+		{
+			for( int y = 0; y < aHeight; ++y )
+			{
+				std::uint32_t* dst = aDst + y*aDstPitch;
+				std::uint32_t const* src = aSrc + y*aSrcPitch;
+				std::uint32_t* const end = dst + aWidth;
+
+				while( dst != end && 0 != (reinterpret_cast<std::uintptr_t>(dst) & 15) )
+					*dst++ = *src++;
+
+				std::uint32_t* const blockEnd = dst + ((end - dst) & ~std::ptrdiff_t(3));
+				for( ; dst != blockEnd; dst += 4, src += 4 )
+				{
+					auto const value = _mm_loadu_si128( reinterpret_cast<__m128i const*>(src) );
+					_mm_stream_si128( reinterpret_cast<__m128i*>(dst), value );
+				}
+
+				while( dst != end )
+					*dst++ = *src++;
+			}
+
+			_mm_sfence();
+			return;
+		}
+#		else // !DRAW2D_X86
+		(void)aStream;
+#		endif // ~ DRAW2D_X86
+
+		for( int y = 0; y < aHeight; ++y )
+			std::memcpy( aDst + y*aDstPitch, aSrc + y*aSrcPitch, sizeof(std::uint32_t)*std::size_t(aWidth) );
+	}
+}
@@ -0,0 +1,33 @@
+#ifndef BLOCK_KERNELS_HPP_9D3E5B27_60A4_4C1F_B8E2_47F1A0C6D953
+#define BLOCK_KERNELS_HPP_9D3E5B27_60A4_4C1F_B8E2_47F1A0C6D953
+
+// Internal to draw2d: filling and copying rectangular blocks of pixels,
+// shared between the surface operations (see surface-ops.hpp), draw.cpp and
+// the SIMD block kernels. Not part of the public API.
+
+#include <cstddef>
+#include <cstdint>
+
+// Blocks of at least this many bytes are written with non-temporal
+// (streaming) stores, unless set_store_mode() says otherwise. Such a block
+// would not stay in the L2 cache anyway (typically 1-2 MB per core).
+// Streaming stores skip reading each cache line before overwriting it, and
+// don't evict the data that the caches do hold.
+constexpr std::size_t kStreamBlockBytes = std::size_t(2) << 20;
+
+// Fills aHeight rows of aWidth pixels with aPixel. aFirst points to the first
+// pixel of the first row; consecutive rows start aPitch pixels apart. Picks
+// the widest stores that the CPU supports (see cpu.hpp), and streaming stores
+// for large blocks (see kStreamBlockBytes).
+void fill_rows( std::uint32_t* aFirst, std::ptrdiff_t aPitch, int aWidth, int aHeight, std::uint32_t aPixel ) noexcept;
+
+// Copies aHeight rows of aWidth pixels from aSrc to aDst, choosing the stores
+// like fill_rows(). The blocks must not overlap.
+void copy_rows( std::uint32_t* aDst, std::ptrdiff_t aDstPitch, std::uint32_t const* aSrc, std::ptrdiff_t aSrcPitch, int aWidth, int aHeight ) noexcept;
+
+// Same as fill_rows() and copy_rows(), with 32-byte stores, streaming or not.
+// Require ESimdLevel::avx2 (see cpu.hpp).
+void fill_rows_avx2( std::uint32_t* aFirst, std::ptrdiff_t aPitch, int aWidth, int aHeight, std::uint32_t aPixel, bool aStream ) noexcept;
+void copy_rows_avx2( std::uint32_t* aDst, std::ptrdiff_t aDstPitch, std::uint32_t const* aSrc, std::ptrdiff_t aSrcPitch, int aWidth, int aHeight, bool aStream ) noexcept;
+
+#endif // BLOCK_KERNELS_HPP_9D3E5B27_60A4_4C1F_B8E2_47F1A0C6D953
@@ -0,0 +1,93 @@
+#include "color.hpp"
+
+#include <limits>
+
+#include <cstring>
+
+namespace
+{
+	std::uint8_t to_srgb_( float ) noexcept;
+	float to_linear_( std::uint8_t ) noexcept;
+}
+
+void linear_to_srgb( std::size_t aCount, ColorF const* aColors, ColorU8_sRGB* aOut ) noexcept
+{
+	assert( 0 == aCount || (aColors && aOut) );
+
+	for( std::size_t i = 0; i < aCount; ++i )
+		aOut[i] = linear_to_srgb( aColors[i] );
+}
+
+SrgbLuts make_srgb_luts() noexcept
+{
+	SrgbLuts luts;
+
+	for( std::size_t i = 0; i < 256; ++i )
+	{
+		luts.toLinear[i] = to_linear_( std::uint8_t(i) );
+		luts.toLinear12[i] = std::uint16_t(luts.toLinear[i] * float(kSrgbLutSize-1) + 0.5f);
+	}
+
+	// Entry i holds the sRGB value for the linear value i/(size-1)
+	for( std::size_t i = 0; i < kSrgbLutSize; ++i )
+		luts.toSrgb[i] = to_srgb_( float(i) / float(kSrgbLutSize-1) );
+
+	// Thresholds: binary search over the bit patterns of the floats in
+	// [0,1]. For non-negative floats, the order of the bit patterns
+	// matches the order of the values.
+	auto const as_float = [] (std::uint32_t aBits) {
+		float ret;
+		std::memcpy( &ret, &aBits, sizeof(float) );
+		return ret;
+	};
+
+	std::uint32_t oneBits;
+	float const one = 1.f;
+	std::memcpy( &oneBits, &one, sizeof(float) );
+
+	luts.toSrgbThreshold[0] = 0.f;
+	for( std::size_t k = 1; k < 257; ++k )
+	{
+		if( k == 256 || to_srgb_( 1.f ) < k )
+		{
+			luts.toSrgbThreshold[k] = std::numeric_limits<float>::infinity();
+			continue;
+		}
+
+		std::uint32_t lo = 0, hi = oneBits; // to_srgb_( hi ) >= k
+		while( lo < hi )
+		{
+			std::uint32_t const mid = lo + (hi-lo)/2;
+			if( to_srgb_( as_float( mid ) ) >= k )
+				hi = mid;
+			else
+				lo = mid+1;
+		}
+
+		luts.toSrgbThreshold[k] = as_float( lo );
+	}
+
+	return luts;
+}
+
+namespace
+{
+	// The tables follow DRAW2D_CFG_SRGB_MODE, except in the LUT mode, where
+	// the conversion functions themselves rely on the tables.
+	std::uint8_t to_srgb_( float aValue ) noexcept
+	{
+#		if DRAW2D_CFG_SRGB_MODE == DRAW2D_CFG_SRGB_LUT
+		return linear_to_srgb_exact( aValue );
+#		else
+		return linear_to_srgb( aValue );
+#		endif
+	}
+	float to_linear_( std::uint8_t aValue ) noexcept
+	{
+#		if DRAW2D_CFG_SRGB_MODE == DRAW2D_CFG_SRGB_LUT
+		return linear_from_srgb_exact( aValue );
+#		else
+		return linear_from_srgb( aValue );
+#		endif
+	}
+}
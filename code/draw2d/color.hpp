@@ -2,6 +2,8 @@
 #define COLOR_HPP_1239E14D_0FDD_4FA5_BF6B_ADB891884682
 
 #include <cmath>
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
 
 /* Compile-time configuration:
@@ -11,6 +13,12 @@
  * FAST uses just a gamma curve with an exponent of 2.4. FASTER approximates 
  * this further by using an exponent of 2.0 (=square and square root).
  *
+ * LUT gives the same results as EXACT, but looks them up in tables instead of
+ * calling std::pow(). A 12-bit table gives a first guess for the 8-bit sRGB
+ * value. Each table entry spans less than the distance between two rounding
+ * thresholds, so the guess is off by at most one. One comparison against the
+ * rounding thresholds on each side corrects it.
+ *
  * [1] https://www.khronos.org/registry/DataFormat/specs/1.3/dataformat.1.3.html#TRANSFER_SRGB
  * [2] https://en.wikipedia.org/wiki/SRGB
  * [2] https://gamedev.stackexchange.com/q/92015
@@ -18,10 +26,11 @@
 #define DRAW2D_CFG_SRGB_EXACT 1
 #define DRAW2D_CFG_SRGB_FAST 2
 #define DRAW2D_CFG_SRGB_FASTER 3
+#define DRAW2D_CFG_SRGB_LUT 4
 
-// The default is to use EXACT. You can change the following to pick a 
-// different method.
-#define DRAW2D_CFG_SRGB_MODE DRAW2D_CFG_SRGB_EXACT
+// The default is to use LUT, which matches EXACT. You can change the following
+// to pick a different method.
+#define DRAW2D_CFG_SRGB_MODE DRAW2D_CFG_SRGB_LUT
 
 
 /** Linear RGB color
@@ -72,5 +81,51 @@ float linear_from_srgb( std::uint8_t aValue ) noexcept;
 ColorU8_sRGB linear_to_srgb( ColorF const& ) noexcept;
 ColorF linear_from_srgb( ColorU8_sRGB const& ) noexcept;
 
+// Convert aCount colors from aColors to aOut. Same results as calling
+// linear_to_srgb() for each color.
+void linear_to_srgb( std::size_t aCount, ColorF const* aColors, ColorU8_sRGB* aOut ) noexcept;
+
+// The published sRGB conversion [1-3], independent of DRAW2D_CFG_SRGB_MODE.
+std::uint8_t linear_to_srgb_exact( float aValue ) noexcept;
+float linear_from_srgb_exact( std::uint8_t aValue ) noexcept;
+
+// Table-driven conversions:
+// These look up precomputed values instead of evaluating the transfer function
+// (e.g., std::pow()) for each value. The tables are built from the functions
+// above, so they follow DRAW2D_CFG_SRGB_MODE (the LUT mode builds them with the
+// *_exact() functions). linear_from_srgb_lut() returns
+// exactly the same value as linear_from_srgb(). linear_to_srgb_lut() quantizes
+// its input to kSrgbLutSize steps first, and may thus differ by one from
+// linear_to_srgb() for some inputs.
+//
+// The *_lut12() variants represent linear values as 12-bit integers in
+// [0,kSrgbLutSize), i.e., directly as an index into the linear-to-sRGB table.
+// This avoids float conversions in per-pixel blending.
+constexpr std::size_t kSrgbLutSize = 4096;
+
+float linear_from_srgb_lut( std::uint8_t aValue ) noexcept;
+std::uint8_t linear_to_srgb_lut( float aValue ) noexcept;
+
+std::uint16_t linear_from_srgb_lut12( std::uint8_t aValue ) noexcept;
+std::uint8_t linear_to_srgb_lut12( std::uint16_t aValue ) noexcept;
+
+struct SrgbLuts
+{
+	float toLinear[256];
+	std::uint16_t toLinear12[256];
+	std::uint8_t toSrgb[kSrgbLutSize];
+
+	// Entry k is the smallest linear value that maps to sRGB value k or
+	// higher. Entry 256 is +infinity.
+	float toSrgbThreshold[257];
+};
+
+// The tables are built on first use, so that the conversions may also be
+// used during static initialization (e.g., by other translation units).
+// Code that uses the tables in a loop should fetch them once, outside of it.
+SrgbLuts const& srgb_luts() noexcept;
+
+SrgbLuts make_srgb_luts() noexcept; // see color.cpp; use srgb_luts()
+
 #include "color.inl"
 #endif // COLOR_HPP_1239E14D_0FDD_4FA5_BF6B_ADB891884682
@@ -1,11 +1,28 @@
+inline
+SrgbLuts const& srgb_luts() noexcept
+{
+	// Thread-safe initialization on first use (C++11 "magic statics")
+	static SrgbLuts const luts = make_srgb_luts();
+	return luts;
+}
+
 inline
 std::uint8_t linear_to_srgb( float aValue ) noexcept
 {
 #	if DRAW2D_CFG_SRGB_MODE == DRAW2D_CFG_SRGB_EXACT
-	if( aValue < 0.0031308f )
-		return std::uint8_t(255.f * 12.92f * aValue + 0.5f);
-	
-	return std::uint8_t(255.f * (1.055f * std::pow( aValue, 1.f/2.4f ) - 0.055f) + 0.5f);
+	return linear_to_srgb_exact( aValue );
+
+#	elif DRAW2D_CFG_SRGB_MODE == DRAW2D_CFG_SRGB_LUT
+	// Values outside of [0,1] are clamped. (Written such that NaN ends up as
+	// zero.)
+	float const value = aValue > 0.f ? (aValue < 1.f ? aValue : 1.f) : 0.f;
+
+	auto const& luts = srgb_luts();
+	int const guess = luts.toSrgb[int(value * float(kSrgbLutSize-1))];
+	return std::uint8_t(guess
+		+ int(value >= luts.toSrgbThreshold[guess+1])
+		- int(value < luts.toSrgbThreshold[guess])
+	);
 
 #	elif DRAW2D_CFG_SRGB_MODE == DRAW2D_CFG_SRGB_FAST
 	return std::uint8_t(255.f * std::pow( aValue, 1.f/2.4f ) + 0.5f);
@@ -19,18 +36,17 @@ std::uint8_t linear_to_srgb( float aValue ) noexcept
 inline
 float linear_from_srgb( std::uint8_t aValue ) noexcept
 {
-	float const fvalue = float(aValue) / 255.f;
-
 #	if DRAW2D_CFG_SRGB_MODE == DRAW2D_CFG_SRGB_EXACT
-	if( fvalue < 0.04045f )
-		return (1.f/12.92f) * fvalue;
+	return linear_from_srgb_exact( aValue );
 
-	return std::pow( (1.f/1.055f) * (fvalue + 0.055f), 2.4f );
+#	elif DRAW2D_CFG_SRGB_MODE == DRAW2D_CFG_SRGB_LUT
+	return srgb_luts().toLinear[aValue];
 
 #	elif DRAW2D_CFG_SRGB_MODE == DRAW2D_CFG_SRGB_FAST
-	return std::pow( fvalue, 2.4f );
+	return std::pow( float(aValue) / 255.f, 2.4f );
 
 #	elif DRAW2D_CFG_SRGB_MODE == DRAW2D_CFG_SRGB_FASTER
+	float const fvalue = float(aValue) / 255.f;
 	return fvalue * fvalue;
 
 #	endif // ~ DRAW2D_CFG_SRGB_MODE
@@ -56,3 +72,52 @@ ColorF linear_from_srgb( ColorU8_sRGB const& aColor ) noexcept
 		linear_from_srgb( aColor.b )
 	};
 }
+
+inline
+std::uint8_t linear_to_srgb_exact( float aValue ) noexcept
+{
+	if( aValue < 0.0031308f )
+		return std::uint8_t(255.f * 12.92f * aValue + 0.5f);
+	
+	return std::uint8_t(255.f * (1.055f * std::pow( aValue, 1.f/2.4f ) - 0.055f) + 0.5f);
+}
+
+inline
+float linear_from_srgb_exact( std::uint8_t aValue ) noexcept
+{
+	float const fvalue = float(aValue) / 255.f;
+
+	if( fvalue < 0.04045f )
+		return (1.f/12.92f) * fvalue;
+
+	return std::pow( (1.f/1.055f) * (fvalue + 0.055f), 2.4f );
+}
+
+inline
+float linear_from_srgb_lut( std::uint8_t aValue ) noexcept
+{
+	return srgb_luts().toLinear[aValue];
+}
+
+inline
+std::uint8_t linear_to_srgb_lut( float aValue ) noexcept
+{
+	// Values outside of [0,1] are clamped. (Written such that NaN ends up as
+	// zero.)
+	constexpr float scale = float(kSrgbLutSize-1);
+	float const index = aValue > 0.f ? scale * aValue + 0.5f : 0.f;
+	return srgb_luts().toSrgb[index < scale ? int(index) : int(kSrgbLutSize-1)];
+}
+
+inline
+std::uint16_t linear_from_srgb_lut12( std::uint8_t aValue ) noexcept
+{
+	return srgb_luts().toLinear12[aValue];
+}
+
+inline
+std::uint8_t linear_to_srgb_lut12( std::uint16_t aValue ) noexcept
+{
+	assert( aValue < kSrgbLutSize );
+	return srgb_luts().toSrgb[aValue];
+}
@@ -0,0 +1,64 @@
+#include "cpu.hpp"
+
+#include <atomic>
+
+#if DRAW2D_X86 && defined(_MSC_VER)
+#	include <intrin.h>
+#endif
+
+namespace
+{
+	ESimdLevel detect_simd_level_() noexcept;
+
+	std::atomic<ESimdLevel> gSimdLimit{ ESimdLevel::avx2 };
+}
+
+ESimdLevel detected_simd_level() noexcept
+{
+	static ESimdLevel const level = detect_simd_level_();
+	return level;
+}
+
+ESimdLevel simd_level() noexcept
+{
+	auto const limit = gSimdLimit.load( std::memory_order_relaxed );
+	auto const detected = detected_simd_level();
+	return limit < detected ? limit : detected;
+}
+
+void set_simd_level_limit( ESimdLevel aLimit ) noexcept
+{
+	gSimdLimit.store( aLimit, std::memory_order_relaxed );
+}
+
+namespace
+{
+	ESimdLevel detect_simd_level_() noexcept
+	{
+#		if DRAW2D_X86 && (defined(__GNUC__) || defined(__clang__))
+		// __builtin_cpu_supports() also checks that the OS saves the YMM
+		// registers (XGETBV), so this is sufficient.
+		__builtin_cpu_init();
+		if( __builtin_cpu_supports( "avx2" ) )
+			return ESimdLevel::avx2;
+#		elif DRAW2D_X86 && defined(_MSC_VER)
+		int regs[4];
+		__cpuid( regs, 0 );
+		int const maxLeaf = regs[0];
+
+		__cpuid( regs, 1 );
+		bool const osxsave = regs[2] & (1<<27);
+		bool const avx = regs[2] & (1<<28);
+
+		// OS must save/restore the XMM and YMM state
+		if( maxLeaf >= 7 && osxsave && avx && 0x6 == (_xgetbv( 0 ) & 0x6) )
+		{
+			__cpuidex( regs, 7, 0 );
+			if( regs[1] & (1<<5) )
+				return ESimdLevel::avx2;
+		}
+#		endif
+
+		return ESimdLevel::scalar;
+	}
+}
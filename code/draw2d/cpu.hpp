@@ -0,0 +1,50 @@
+#ifndef CPU_HPP_ED5951C5_8AAB_4BA3_85EF_CF1BB5A89B4D
+#define CPU_HPP_ED5951C5_8AAB_4BA3_85EF_CF1BB5A89B4D
+
+// Runtime CPU feature detection
+//
+// The draw2d library is compiled for the baseline instruction set of the
+// target (SSE2 on x64). Faster kernels that use newer instruction sets live in
+// separate translation units (e.g., *-avx2.cpp). Those kernels may only be
+// called if simd_level() says that the CPU supports them.
+//
+// Only the kernel functions themselves are compiled for the newer instruction
+// set (see DRAW2D_TARGET_AVX2), not their translation units as a whole: inline
+// functions from shared headers are emitted in every translation unit that
+// uses them, and the linker may keep any one of these copies. A copy compiled
+// for AVX2 could then end up being called on a CPU without AVX2.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#	define DRAW2D_X86 1
+#else
+#	define DRAW2D_X86 0
+#endif
+
+// Marks a function that uses AVX2. Functions called from such a function are
+// inlined into it where possible. GCC and Clang need the attribute to accept
+// the AVX2 intrinsics; MSVC accepts them anywhere.
+#if DRAW2D_X86 && (defined(__GNUC__) || defined(__clang__))
+#	define DRAW2D_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#	define DRAW2D_TARGET_AVX2
+#endif
+
+enum class ESimdLevel
+{
+	scalar, // baseline (includes SSE2 on x64)
+	avx2
+};
+
+// Highest SIMD level supported by the CPU (and OS), detected once.
+ESimdLevel detected_simd_level() noexcept;
+
+// SIMD level that the draw2d functions should use. This is the detected
+// level, unless it is capped by set_simd_level_limit().
+ESimdLevel simd_level() noexcept;
+
+// Cap the SIMD level used by draw2d. This is mainly intended for tests and
+// benchmarks that want to compare the different code paths. The limit is
+// global; it should not be changed while drawing is in progress.
+void set_simd_level_limit( ESimdLevel ) noexcept;
+
+#endif // CPU_HPP_ED5951C5_8AAB_4BA3_85EF_CF1BB5A89B4D
@@ -1,10 +1,160 @@
 #include "draw.hpp"
 
+#include <vector>
 #include <algorithm>
+#include <type_traits>
 
 #include <cmath>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 
+#include "cpu.hpp"
 #include "surface.hpp"
+#include "block-kernels.hpp"
+#include "line-kernels.hpp"
+#include "triangle-kernels.hpp"
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#endif
+
+namespace
+{
+	// Line end points are converted to 24.8 fixed point. Coordinates are
+	// limited to +/- kMaxCoord pixels, such that the intermediate values in
+	// setup_line_() fit into 64-bit integers. (Fixed point values are rounded
+	// down with an arithmetic right shift.)
+	constexpr int kFixedShift = 8;
+	constexpr std::int64_t kFixedOne = std::int64_t(1) << kFixedShift;
+	constexpr std::int64_t kFixedHalf = kFixedOne/2;
+	constexpr std::int64_t kMaxCoord = std::int64_t(1) << 21;
+
+	bool setup_line_( LineSetup&, int aWidth, int aHeight, float aX0, float aY0, float aX1, float aY1 ) noexcept;
+	bool to_fixed_( std::int64_t&, std::int64_t&, std::int64_t&, std::int64_t&, float, float, float, float ) noexcept;
+	std::int64_t round_fixed_( float ) noexcept;
+	void draw_line_runs_( Surface&, LineSetup const&, std::uint32_t aPixel ) noexcept;
+	template< int tMajorStride >
+	void fill_line_runs_( std::uint32_t*, std::ptrdiff_t aMajorStride, std::ptrdiff_t aMinorStride, LineSetup const&, std::uint32_t aPixel ) noexcept;
+
+	// Pixels covered by an axis-aligned rectangle (see draw_rectangle_solid()).
+	// Not clipped to the surface, but clamped to one pixel outside of it on
+	// each side. Returns false if the rectangle covers no pixels.
+	bool rectangle_pixels_( PixelRect&, Surface const&, Vec2f aMinCorner, Vec2f aMaxCorner ) noexcept;
+
+	std::uint32_t* pixel_ptr_( Surface&, int aX, int aY ) noexcept;
+
+	// Mark the pixels that a line may cover as dirty (see Surface). The
+	// bounds are conservative, e.g., they assume a step along the minor axis
+	// with each pixel.
+	void mark_line_( Surface&, LineSetup const& ) noexcept;
+
+	void fill_run_( std::uint32_t*, std::ptrdiff_t aStride, int aCount, std::uint32_t aPixel ) noexcept;
+
+	// Coverage is given in 1/256 units, i.e., in [0,256]
+	constexpr int kCoverageShift = 8;
+	constexpr int kCoverageOne = 1 << kCoverageShift;
+
+	int coverage_( double aFraction ) noexcept;
+	void blend_linear_( std::uint8_t*, std::uint16_t const aColorLinear[3], int aCoverage ) noexcept;
+
+	std::int64_t floor_div_( std::int64_t, std::int64_t ) noexcept;
+	std::int64_t ceil_div_( std::int64_t, std::int64_t ) noexcept;
+
+	// Lines that are waiting to be drawn by the multi-line kernel
+	struct LineGroup_
+	{
+		bool simd;
+		std::size_t count;
+		LineSetup lines[kLineLanes];
+		std::uint32_t pixels[kLineLanes];
+	};
+
+	void group_line_( Surface&, LineGroup_&, LineSetup const&, std::uint32_t aPixel ) noexcept;
+	void flush_line_group_( Surface&, LineGroup_& ) noexcept;
+
+	template< typename tColorFn >
+	void draw_lines_( Surface&, std::size_t, float const*, float const*, float const*, float const*, ELineOrder, tColorFn&& );
+
+	// Horizontal run of pixels [x0,x1) in row y
+	struct RowSpan_
+	{
+		int y, x0, x1;
+	};
+
+	// Triangles are rasterized in the same 24.8 fixed point as lines. Larger
+	// triangles are first clipped to a guard band of +/- kGuardCoord pixels,
+	// which keeps the edge functions within 64-bit integers.
+	constexpr double kGuardCoord = double(kMaxCoord/2);
+
+	// The rasterizer calls aSpanFn( row, x0, x1, y ) for each covered run
+	// [x0,x1) of pixels in row y; row points to the first pixel in that row.
+	template< typename tSpanFn >
+	void rasterize_triangle_( Surface&, PixelRect const&, Vec2f, Vec2f, Vec2f, tSpanFn&& );
+	template< typename tSpanFn >
+	void rasterize_fixed_triangle_( Surface&, PixelRect const&, std::int64_t const aX[3], std::int64_t const aY[3], tSpanFn&& );
+
+	// Calls aRasterFn( spanFn ) with a span function that shades spans with
+	// the color planes aPlanes (eight pixels at a time with AVX2).
+	template< typename tRasterFn >
+	void with_interp_spans_( ColorPlane const aPlanes[3], tRasterFn&& );
+
+	// Calls aRasterFn( shade ) with a function shade( row, x0, x1, y, planes )
+	// that shades spans with the given color planes.
+	template< typename tRasterFn >
+	void with_interp_shader_( tRasterFn&& );
+
+	void shade_span_interp_scalar_( std::uint32_t* aRow, int aX0, int aX1, int aY, ColorPlane const aPlanes[3] ) noexcept;
+
+	// Vertex of an indexed batch: transformed position and, if the position
+	// lies within the guard band, its fixed point coordinates.
+	struct BatchVertex_
+	{
+		Vec2f pos;
+		std::int64_t x, y;
+		bool fixed;
+	};
+
+	// Span function that fills spans with a single (packed) pixel value
+	struct SolidSpan_
+	{
+		std::uint32_t pixel;
+
+		void operator() (std::uint32_t* aRow, int aX0, int aX1, int) const noexcept
+		{
+			fill_run_( aRow + aX0, 1, aX1 - aX0, pixel );
+		}
+	};
+
+	// Indexed triangles and fans. With aColors, they are shaded from the
+	// per-vertex colors (triangles of uniform color are filled, see
+	// uniform_color()); without, they are filled with aPixel.
+	void rasterize_indexed_( Surface&, PixelRect const&, std::size_t aVertexCount, Vec2f const*, ColorF const*, std::uint32_t aPixel, std::size_t aTriangleCount, std::uint32_t const*, Mat22f const&, Vec2f );
+	void rasterize_fan_( Surface&, PixelRect const&, std::size_t aCount, Vec2f const*, ColorF const*, std::uint32_t aPixel, Mat22f const&, Vec2f );
+
+	template< typename tSpanFn >
+	void rasterize_batch_triangle_( Surface&, PixelRect const&, BatchVertex_ const&, BatchVertex_ const&, BatchVertex_ const&, tSpanFn&& );
+
+	// Edge function of a fan edge, with the same bias as in
+	// rasterize_fixed_triangle_(). e is the value at the center of the scan's
+	// first pixel; stepX and stepY are the steps per pixel and per row.
+	struct FanEdge_
+	{
+		std::int64_t e, stepX, stepY;
+	};
+
+	FanEdge_ make_fan_edge_( std::int64_t aX0, std::int64_t aY0, std::int64_t aX1, std::int64_t aY1, std::int64_t aPX, std::int64_t aPY ) noexcept;
+	void fan_edge_bound_( FanEdge_ const&, int aRow, std::int64_t& aBound, bool& aIsBegin ) noexcept;
+
+	PixelRect surface_rect_( Surface const& ) noexcept;
+
+	// Statistics are collected per thread, see raster_stats().
+	thread_local RasterStats gRasterStats{};
+
+	void set_bits_( std::uint64_t*, int aBegin, int aEnd ) noexcept;
+	int count_trailing_zeros_( std::uint64_t ) noexcept;
+}
 
 //void draw_line_solid( Surface& aSurface, Vec2f aBegin, Vec2f aEnd, ColorU8_sRGB aColor )
 //{
@@ -19,228 +169,312 @@
 //	(void)aColor;
 //}
 
-void draw_line_solid(Surface& aSurface, Vec2f aBegin, Vec2f aEnd, ColorU8_sRGB aColor)
+void draw_line_solid( Surface& aSurface, Vec2f aBegin, Vec2f aEnd, ColorU8_sRGB aColor )
 {
-	//TODO: your implementation goes here
-	//task 1.2
+	// Bresenham, with the line clipped analytically against the surface
+	// before any stepping takes place (see setup_line_()). Only the visible
+	// pixels are visited, and the rasterizer doesn't need any bounds checks.
+	LineSetup line;
+	if( !setup_line_( line, 
+		int(aSurface.get_width()), int(aSurface.get_height()),
+		aBegin.x, aBegin.y,
+		aEnd.x, aEnd.y
+	) )
+	{
+		return;
+	}
 
-	//build line between aBegin and aEnd
-	//make line as thin as possible: single pixel width 
-	//use parametric equation
-	//use clipping
-	//pick drawing method: bresenham's line drawing algorithm
-	//method must do O(N) scaling
+	draw_line_runs_( aSurface, line, pack_rgbx( aColor ) );
+}
 
+void draw_lines_solid( Surface& aSurface, std::size_t aCount, float const* aX0, float const* aY0, float const* aX1, float const* aY1, ColorU8_sRGB const* aColors, ELineOrder aOrder )
+{
+	assert( aColors || 0 == aCount );
+	draw_lines_( aSurface, aCount, aX0, aY0, aX1, aY1, aOrder, 
+		[aColors] (std::size_t aIdx) { return aColors[aIdx]; }
+	);
+}
+void draw_lines_solid( Surface& aSurface, std::size_t aCount, float const* aX0, float const* aY0, float const* aX1, float const* aY1, ColorU8_sRGB aColor, ELineOrder aOrder )
+{
+	draw_lines_( aSurface, aCount, aX0, aY0, aX1, aY1, aOrder, 
+		[aColor] (std::size_t) { return aColor; }
+	);
+}
 
-	// we calculate the differences in x and y coordinates between the two points
-	// to get the length of our line/vector
-	//abs() return absolute positive int
-	//we decide the direction of the line in the next step
+void draw_line_aa( Surface& aSurface, Vec2f aBegin, Vec2f aEnd, ColorU8_sRGB aColor )
+{
+	// Xiaolin Wu's algorithm. The line is first shifted by half a pixel, such
+	// that pixel centers lie at integer coordinates. The "major" axis is the
+	// one along which the line is longer; each major column (or row) covers
+	// two pixels along the minor axis.
+	//
+	// Coordinates are handled in double precision, and the minor coordinate
+	// is computed directly for each column (rather than accumulated), so
+	// that clipping does not change the visible pixels.
+	double x0 = double(aBegin.x) - 0.5, y0 = double(aBegin.y) - 0.5;
+	double x1 = double(aEnd.x) - 0.5, y1 = double(aEnd.y) - 0.5;
 
+	if( !std::isfinite( x0 ) || !std::isfinite( y0 ) || !std::isfinite( x1 ) || !std::isfinite( y1 ) )
+		return;
 
-	int coord_length_x = abs(static_cast<int>(aEnd.x) - static_cast<int>(aBegin.x));
-	int coord_length_y = abs(static_cast<int>(aEnd.y) - static_cast<int>(aBegin.y));
+	auto const width = std::ptrdiff_t(aSurface.get_width());
+	auto const height = std::ptrdiff_t(aSurface.get_height());
+	if( 0 == width || 0 == height )
+		return;
 
-	// we need to determine the direction of the line/vector (1 or -1 for each axis)
-	int direction_x, direction_y;
+	// The pixels straddling the line, rounded outwards (and clamped before
+	// the conversion to int).
+	{
+		auto const bound = [] (double aValue, std::ptrdiff_t aSize) {
+			return int(std::clamp( aValue, -1.0, double(aSize)+1.0 ));
+		};
 
-	if (aBegin.x < aEnd.x) {
-		direction_x = 1;
-	}
-	else {
-		direction_x = -1;
+		aSurface.mark_dirty( PixelRect{
+			bound( std::floor( std::min( x0, x1 ) ), width ), bound( std::floor( std::min( y0, y1 ) ), height ),
+			bound( std::floor( std::max( x0, x1 ) ) + 2.0, width ), bound( std::floor( std::max( y0, y1 ) ) + 2.0, height )
+		} );
 	}
 
-	if (aBegin.y < aEnd.y) {
-		direction_y = 1;
+	auto const pixelStride = std::ptrdiff_t(aSurface.get_linear_index( 1, 0 ));
+	auto const rowStride = std::ptrdiff_t(height > 1 ? aSurface.get_linear_index( 0, 1 ) : 0);
+
+	bool const steep = std::abs( y1 - y0 ) > std::abs( x1 - x0 );
+	if( steep )
+	{
+		std::swap( x0, y0 );
+		std::swap( x1, y1 );
 	}
-	else {
-		direction_y = -1;
+	if( x0 > x1 )
+	{
+		std::swap( x0, x1 );
+		std::swap( y0, y1 );
 	}
 
-	//I used the bresenham's line drawing algorithm so we need to
-	// initialize the slope error and current coordinates
-	// slope_error is the difference between the actual position of the line and 
-	//the ideal position of the line
-	int slope_error = coord_length_x - coord_length_y;
-	int x = static_cast<int>(aBegin.x);
-	int y = static_cast<int>(aBegin.y);
+	auto const majorSize = steep ? height : width;
+	auto const minorSize = steep ? width : height;
+	auto const majorStride = steep ? rowStride : pixelStride;
+	auto const minorStride = steep ? pixelStride : rowStride;
 
-	int width = aSurface.get_width();
-	int height = aSurface.get_height();
+	// Columns covered by the end points. Reject the line early if these are
+	// outside the surface. This also keeps the values below in integer range.
+	double const first = std::floor( x0 + 0.5 );
+	double const last = std::floor( x1 + 0.5 );
+	if( last < 0.0 || first >= double(majorSize) )
+		return;
 
-	while (true) {
-		// Check if the our coordinates x&y are within the bounds of the surface
-		if (x >= 0 && x < width && y >= 0 && y < height) {
-			// Set the pixel at the current coordinates to the specified color
-			aSurface.set_pixel_srgb(x, y, aColor);
-		}
+	double const dx = x1 - x0;
+	double const gradient = dx > 0.0 ? (y1 - y0) / dx : 0.0;
 
-		// If the current coordinates are equal to the end point (end of the vector), exit the loop
-		//this line also handels the clipping aspect
-		if (x == static_cast<int>(aEnd.x) && y == static_cast<int>(aEnd.y)) {
-			break;
-		}
+	std::uint16_t const colorLinear[3] = {
+		linear_from_srgb_lut12( aColor.r ),
+		linear_from_srgb_lut12( aColor.g ),
+		linear_from_srgb_lut12( aColor.b )
+	};
 
-		//we double the error 
-		int slope_error2 = 2 * slope_error;
+	std::uint8_t* const base = aSurface.get_surface_ptr();
 
-		// Calculate the step for the x and y directions
-		//we give the line a direction "up"/"down" on the axis
-		// the line moves a pixel
-		//the line's position is closer to the ideal position 
-		//in the y-direction (vertical) than in the x-direction (horizontal)
-		if (slope_error2 > -coord_length_y) {
-			slope_error = slope_error - coord_length_y;
-			x = x + direction_x;
-		}
-		//the line's position is closer to the ideal position in the x-direction
-		if (slope_error2 < coord_length_x) {
-			slope_error = slope_error + coord_length_x;
-			y = y + direction_y;
-		}
-	}
-}
+	// Blend the two pixels at major coordinate aMajor that straddle the minor
+	// coordinate aMinor. With aClipped (std::true_type), pixels outside of
+	// the surface are skipped. With std::false_type, the checks compile away,
+	// and the caller guarantees that both pixels are inside.
+	auto const plot = [&] (auto aClipped, std::ptrdiff_t aMajor, double aMinor, int aCoverage) {
+		if( aClipped && !(aMinor >= -1.0 && aMinor < double(minorSize)) )
+			return;
 
-void draw_triangle_wireframe( Surface& aSurface, Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorU8_sRGB aColor )
-{
-	//TODO: your implementation goes here
-	//task 1.4
-	//we have to first draw the outline of the triangles
-	draw_line_solid(aSurface, aP0, aP1, aColor);
-	draw_line_solid(aSurface, aP1, aP2, aColor);
-	draw_line_solid(aSurface, aP2, aP0, aColor);
-}
+		// Note: floor via truncation; std::floor() may be a library call
+		// when SSE4.1 isn't enabled.
+		auto minor = std::ptrdiff_t(aMinor);
+		minor -= double(minor) > aMinor ? 1 : 0;
 
+		auto const frac = int((aMinor - double(minor)) * kCoverageOne + 0.5);
+		auto const lower = (frac * aCoverage + kCoverageOne/2) / kCoverageOne;
 
+		std::uint8_t* const ptr = base + aMajor*majorStride + minor*minorStride;
 
-void draw_triangle_solid(Surface& aSurface, Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorU8_sRGB aColor)
-{
-	//TODO: your implementation goes here
-	//task 1.4
-	//defined by 3 vertices & filled with solid colour
-	//pick drawing method and it has to be O(N)
-	//deal with clipping
-	
-	// method i used: scanline filling, fills diff triangles(flat bottom and top, or general ones)
-	// Sort vertices by their y coordinate
-	//aP0 left vertex, aP1 top vertex, aP2 right vertex 
-	if (aP0.y > aP1.y) std::swap(aP0, aP1);
-	if (aP0.y > aP2.y) std::swap(aP0, aP2);
-	if (aP1.y > aP2.y) std::swap(aP1, aP2);
-
-	// we check for degenerate triangles
-	//no triangle is formed if the vertices lie on the horizontal line  
-	if (aP0.y == aP2.y) return;
-
-	int width = aSurface.get_width();
-	int height = aSurface.get_height();
-
-	// one handles top flat triangles
-	if (aP0.y == aP1.y)
-	{
-		for (int y = static_cast<int>(aP0.y); y <= static_cast<int>(aP2.y); ++y)
-		{
-			//slope ecuation for starting x coordinates
-			// Left Slope= (x1?x0)/(y1?y0)
-			//Liner interpolation formula: startX=x0+(y?y0)*Left Slope
-			int startLeftEdgeX = static_cast<int>(aP0.x + (y - aP0.y) * ((aP2.x - aP0.x) / (aP2.y - aP0.y)));
-			//slope ecuation for ending x coordinates
-			// right Slope= (x2?x1)/(y2?y1)
-			//Liner interpolation formula: endX=x1+(y?y1)*Right Slope
-			int endRightEdgeX = static_cast<int>(aP1.x + (y - aP1.y) * ((aP2.x - aP1.x) / (aP2.y - aP1.y)));
-
-			for (int x = startLeftEdgeX; x <= endRightEdgeX; ++x)
-			{
-				// Check if the our coordinates x&y are within the bounds of the surface
-				if (x >= 0 && x < width && y >= 0 && y < height) {
-					// Set the pixel at the current coordinates to the specified color
-					aSurface.set_pixel_srgb(x, y, aColor);
-				}
-			}
-		}
+		if( !aClipped || minor >= 0 )
+			blend_linear_( ptr, colorLinear, aCoverage - lower );
+		if( !aClipped || minor+1 < minorSize )
+			blend_linear_( ptr + minorStride, colorLinear, lower );
+	};
+
+	auto const minor_at = [&] (double aMajor) {
+		return y0 + gradient * (aMajor - x0);
+	};
+
+	// End points: the coverage is the part of the end column that the line
+	// spans. If both end points fall into the same column, that's simply the
+	// line's length along the major axis.
+	if( first == last )
+	{
+		plot( std::true_type{}, std::ptrdiff_t(first), minor_at( first ), coverage_( dx ) );
+		return;
 	}
-	//one handles bottom flat triangles
-	else if (aP1.y == aP2.y)
+
+	if( first >= 0.0 )
+		plot( std::true_type{}, std::ptrdiff_t(first), minor_at( first ), coverage_( first + 0.5 - x0 ) );
+	if( last < double(majorSize) )
+		plot( std::true_type{}, std::ptrdiff_t(last), minor_at( last ), coverage_( x1 - (last - 0.5) ) );
+
+	// Interior columns, clipped to the surface along the major axis and (with
+	// one column of slack for rounding) along the minor axis. plot() still
+	// checks each column, so the slack does not affect the result.
+	double begin = std::max( first + 1.0, 0.0 );
+	double end = std::min( last - 1.0, double(majorSize-1) );
+
+	if( gradient != 0.0 )
 	{
-		for (int y = static_cast<int>(aP0.y); y <= static_cast<int>(aP2.y); ++y)
-		{
-			int startLeftEdgeX = static_cast<int>(aP0.x + (y - aP0.y) * ((aP1.x - aP0.x) / (aP1.y - aP0.y)));
-			int endRightEdgeX = static_cast<int>(aP0.x + (y - aP0.y) * ((aP2.x - aP0.x) / (aP2.y - aP0.y)));
+		double const a = x0 + (-1.0 - y0) / gradient;
+		double const b = x0 + (double(minorSize) - y0) / gradient;
+		begin = std::max( begin, std::floor( std::min( a, b ) ) - 1.0 );
+		end = std::min( end, std::ceil( std::max( a, b ) ) + 1.0 );
+	}
 
-			for (int x = startLeftEdgeX; x <= endRightEdgeX; ++x)
-			{
-				// Check if the our coordinates x&y are within the bounds of the surface
-				if (x >= 0 && x < width && y >= 0 && y < height) {
-					// Set the pixel at the current coordinates to the specified color
-					aSurface.set_pixel_srgb(x, y, aColor);
-				}
-			}
-		}
+	if( begin > end )
+		return;
+
+	// minor_at() is monotonic (also with rounding), so if both ends of the
+	// range keep both pixels inside of the surface, all columns do. This is
+	// the common case, and it runs without any per-pixel checks.
+	auto const majorBegin = std::ptrdiff_t(begin), majorEnd = std::ptrdiff_t(end);
+
+	double const minorBegin = minor_at( begin ), minorEnd = minor_at( end );
+	if( std::min( minorBegin, minorEnd ) >= 0.0 && std::max( minorBegin, minorEnd ) < double(minorSize-1) )
+	{
+		for( auto major = majorBegin; major <= majorEnd; ++major )
+			plot( std::false_type{}, major, minor_at( double(major) ), kCoverageOne );
 	}
 	else
 	{
-		//this is for most(general) triangles that need to be split
-		// we split the triangle into a bottom flat and top flat triangles
-		Vec2f splitEdge;
-		//Interpolated Value = Start Value +Total Distance/Fractional Distance*(End Value?Start Value)
-		// we calculate x axis interpolated value
-		float interpolatedValueX = aP0.x + ((float)(aP1.y - aP0.y) / (float)(aP2.y - aP0.y)) * (aP2.x - aP0.x);
-		// we calculate y axis interpolated value
-		float interpolatedValueY = aP1.y;
+		for( auto major = majorBegin; major <= majorEnd; ++major )
+			plot( std::true_type{}, major, minor_at( double(major) ), kCoverageOne );
+	}
+}
+
+std::size_t draw_triangles_solid( Surface& aSurface, std::size_t aCount, Vec2f const* aVertices, ColorU8_sRGB aColor )
+{
+	assert( aVertices || 0 == aCount );
+
+	// The triangles are rasterized like in draw_triangle_solid(), with the
+	// same fill rule, but their spans are collected instead of being filled.
+	// The spans are then bucketed by row (counting sort), and each row's
+	// spans are merged in a bit mask with one bit per pixel. Finally, the
+	// runs of set bits are filled. Overlapping triangles thus don't cause
+	// any overdraw.
+	int const width = int(aSurface.get_width());
+	int const height = int(aSurface.get_height());
+	PixelRect const clip = surface_rect_( aSurface );
+
+	// The buffers are kept per thread and reused, so that batches don't
+	// allocate once the buffers have grown to size.
+	thread_local std::vector<RowSpan_> collected, spans;
+	thread_local std::vector<std::size_t> rowStart, next;
+	thread_local std::vector<std::uint64_t> mask;
+
+	collected.clear();
+	rowStart.assign( std::size_t(height)+1, 0 );
+
+	for( std::size_t i = 0; i < aCount; ++i )
+	{
+		rasterize_triangle_( aSurface, clip, aVertices[3*i+0], aVertices[3*i+1], aVertices[3*i+2], [&] (std::uint32_t*, int aX0, int aX1, int aY) {
+			collected.emplace_back( RowSpan_{ aY, aX0, aX1 } );
+			++rowStart[std::size_t(aY)+1];
+		} );
+	}
 
-		// Split the triangle into a bottom flat and top flat triangles
-		if (aP1.y == aP2.y)
-		{
-			// Handle bottom flat triangles
-			splitEdge.x = interpolatedValueX;
-			splitEdge.y = aP1.y;
-		}
-		else if (aP0.y == aP1.y)
-		{
-			// Handle top flat triangles
-			splitEdge.x = interpolatedValueX;
-			splitEdge.y = aP1.y;
-		}
-		else
+	if( collected.empty() )
+		return 0;
+
+	// Counts (rowStart[y+1] = spans in row y) to offsets
+	for( std::size_t y = 0; y < std::size_t(height); ++y )
+		rowStart[y+1] += rowStart[y];
+
+	spans.resize( collected.size() );
+	next.assign( rowStart.begin(), rowStart.end() );
+	for( auto const& span : collected )
+		spans[next[std::size_t(span.y)]++] = span;
+
+	std::uint32_t const pixel = pack_rgbx( aColor );
+	std::size_t written = 0;
+
+	mask.assign( std::size_t(width+63) / 64, 0 );
+
+	for( std::size_t y = 0; y < std::size_t(height); ++y )
+	{
+		if( rowStart[y] == rowStart[y+1] )
+			continue;
+
+		// The rasterizer only emits non-empty spans, and it has already
+		// marked their tiles as dirty.
+		int first = width, last = 0;
+		for( auto i = rowStart[y]; i < rowStart[y+1]; ++i )
 		{
-			// General case, other cases
-			splitEdge.x = interpolatedValueX;
-			splitEdge.y = interpolatedValueY;
+			set_bits_( mask.data(), spans[i].x0, spans[i].x1 );
+			first = std::min( first, spans[i].x0 );
+			last = std::max( last, spans[i].x1 );
 		}
 
-		// Handle bottom flat triangles
-		for (int y = static_cast<int>(aP0.y); y <= static_cast<int>(aP1.y); ++y)
+		// Find runs of set bits: alternately search for the next set bit
+		// (start of a run) and the next clear bit (end of a run). Words are
+		// cleared once they have been processed.
+		std::uint32_t* const row = pixel_ptr_( aSurface, 0, int(y) );
+
+		bool inRun = false;
+		int runStart = 0;
+
+		for( int word = first / 64; word <= (last-1) / 64; ++word )
 		{
-			//again we do liner interpolation
-			int startLeftEdgeX = static_cast<int>(aP0.x + (y - aP0.y) * ((aP1.x - aP0.x) / (aP1.y - aP0.y)));
-			int endRightEdgeX = static_cast<int>(aP0.x + (y - aP0.y) * ((splitEdge.x - aP0.x) / (splitEdge.y - aP0.y)));
+			std::uint64_t const bits = mask[std::size_t(word)];
+			mask[std::size_t(word)] = 0;
 
-			for (int x = startLeftEdgeX; x <= endRightEdgeX; ++x)
+			std::uint64_t search = inRun ? ~bits : bits;
+			while( search )
 			{
-				// Check if the our coordinates x&y are within the bounds of the surface
-				if (x >= 0 && x < width && y >= 0 && y < height) {
-					// Set the pixel at the current coordinates to the specified color
-					aSurface.set_pixel_srgb(x, y, aColor);
+				int const pos = word*64 + count_trailing_zeros_( search );
+				if( inRun )
+				{
+					fill_run_( row + runStart, 1, pos - runStart, pixel );
+					written += std::size_t(pos - runStart);
+				}
+				else
+				{
+					runStart = pos;
 				}
+
+				inRun = !inRun;
+
+				int const bit = pos - word*64;
+				search = (inRun ? ~bits : bits) & (~std::uint64_t(0) << bit);
 			}
 		}
-		// Handle top flat triangles
-		for (int y = static_cast<int>(aP1.y) + 1; y <= static_cast<int>(aP2.y); ++y)
-		{
-			int startLeftEdgeX = static_cast<int>(aP1.x + (y - aP1.y) * ((aP2.x - aP1.x) / (aP2.y - aP1.y)));
-			int endRightEdgeX = static_cast<int>(aP0.x + (y - aP0.y) * ((splitEdge.x - aP0.x) / (splitEdge.y - aP0.y)));
 
-			for (int x = startLeftEdgeX; x <= endRightEdgeX; ++x)
-			{
-				// Check if the our coordinates x&y are within the bounds of the surface
-				if (x >= 0 && x < width && y >= 0 && y < height) {
-					// Set the pixel at the current coordinates to the specified color
-					aSurface.set_pixel_srgb(x, y, aColor);
-				}
-			}
+		if( inRun )
+		{
+			fill_run_( row + runStart, 1, last - runStart, pixel );
+			written += std::size_t(last - runStart);
 		}
 	}
+
+	return written;
+}
+
+void draw_triangle_wireframe( Surface& aSurface, Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorU8_sRGB aColor )
+{
+	//TODO: your implementation goes here
+	//task 1.4
+	//we have to first draw the outline of the triangles
+	draw_line_solid(aSurface, aP0, aP1, aColor);
+	draw_line_solid(aSurface, aP1, aP2, aColor);
+	draw_line_solid(aSurface, aP2, aP0, aColor);
+}
+
+
+
+void draw_triangle_solid( Surface& aSurface, Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorU8_sRGB aColor )
+{
+	// Half-space rasterizer with integer edge functions and a top-left fill
+	// rule, see rasterize_triangle_(). Triangles that share an edge neither
+	// overlap nor leave gaps.
+	rasterize_triangle_solid( aSurface, surface_rect_( aSurface ), aP0, aP1, aP2, aColor );
 }
 
 
@@ -274,86 +508,1343 @@ void draw_triangle_solid(Surface& aSurface, Vec2f aP0, Vec2f aP1, Vec2f aP2, Col
 //	(void)aC2;
 //}
 
-void draw_triangle_interp(Surface& aSurface, Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorF aC0, ColorF aC1, ColorF aC2)
+void draw_triangle_interp( Surface& aSurface, Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorF aC0, ColorF aC1, ColorF aC2 )
 {
-	// Calculate the bounding box of the triangle
-	//this helps with efficincy, limit the surface that is taking into consideration of randering
-	// and clipping, make sure we don't generate pixels outside of the range of the surface
-	Vec2f boundingBoxMin;
-	boundingBoxMin.x = (aP0.x < aP1.x) ? ((aP0.x < aP2.x) ? aP0.x : aP2.x) : ((aP1.x < aP2.x) ? aP1.x : aP2.x);
-	boundingBoxMin.y = (aP0.y < aP1.y) ? ((aP0.y < aP2.y) ? aP0.y : aP2.y) : ((aP1.y < aP2.y) ? aP1.y : aP2.y);
-
-	// Calculate the bounding box of the triangle
-	Vec2f boundingBoxMax;
-	boundingBoxMax.x = (aP0.x > aP1.x) ? ((aP0.x > aP2.x) ? aP0.x : aP2.x) : ((aP1.x > aP2.x) ? aP1.x : aP2.x);
-	boundingBoxMax.y = (aP0.y > aP1.y) ? ((aP0.y > aP2.y) ? aP0.y : aP2.y) : ((aP1.y > aP2.y) ? aP1.y : aP2.y);
-
-	// Clamp: limit the value of the range to ensure the values are within valid bounds
-	boundingBoxMin.x = (boundingBoxMin.x < 0) ? 0 : boundingBoxMin.x;
-	boundingBoxMin.y = (boundingBoxMin.y < 0) ? 0 : boundingBoxMin.y;
-	//these are used for cases such: when we have an image with valid pixel indices ranging from 0 to image_width - 1 
-	// for the horizontal axis and 0 to image_height - 1 for the vertical axis
-	//basically limmiting the bounds in which we calculate/draw pixels
-	boundingBoxMax.x = (boundingBoxMax.x >= aSurface.get_width()) ? (aSurface.get_width() - 1) : boundingBoxMax.x;
-	boundingBoxMax.y = (boundingBoxMax.y >= aSurface.get_height()) ? (aSurface.get_height() - 1) : boundingBoxMax.y;
-
-	// calculating some constants
-	float areaTriangle = (aP1.x - aP0.x) * (aP2.y - aP0.y) - (aP2.x - aP0.x) * (aP1.y - aP0.y);
-	//barycentric coordinate interpolation within a triangle, reciprocal of the area
-	//a normalization factor that helps achieve correct barycentric interpolation within the triangle
-	float inverseArea = 1.0f / areaTriangle;
-
-	// Check if the area is 0, and skip the pixel/triangle
-	if (areaTriangle == 0) {
+	// Same rasterizer as draw_triangle_solid(), so both cover exactly the
+	// same pixels. The color is linear in x and y, and is evaluated from the
+	// plane equations. With AVX2, spans are shaded eight pixels at a time
+	// (see triangle-kernels.hpp). Triangles whose vertices all have the same
+	// sRGB color are filled instead (see uniform_color()).
+	ColorU8_sRGB uniform;
+	if( uniform_color( aC0, aC1, aC2, uniform ) )
+	{
+		rasterize_triangle_solid( aSurface, surface_rect_( aSurface ), aP0, aP1, aP2, uniform );
 		return;
 	}
 
-	// a nested loop that goes over the bounding box
-	for (int x = static_cast<int>(boundingBoxMin.x); x <= static_cast<int>(boundingBoxMax.x); x++) {
-		for (int y = static_cast<int>(boundingBoxMin.y); y <= static_cast<int>(boundingBoxMax.y); y++) {
-			// here we finally calculate barycentric coordinates u, v
-			//barycentric coordinates:b0,b1,b2
-			float b0 = ((aP1.x - aP0.x) * (y - aP0.y) - (x - aP0.x) * (aP1.y - aP0.y)) * inverseArea;
-			float b1 = ((x - aP0.x) * (aP2.y - aP0.y) - (aP2.x - aP0.x) * (y - aP0.y)) * inverseArea;
-			float b2 = 1.0f - b0 - b1;
-
-			if (b0 >= 0 && b1 >= 0 && b2 >= 0) {
-				// this alg allows us to have different shades of colour, opposed to a single solid colour
-				// so we need to interpolate colors using the barycentric coordinates
-				ColorF interpolatedColour;
-				interpolatedColour.r = (aC0.r * b0 + aC1.r * b1 + aC2.r * b2);
-				interpolatedColour.g = (aC0.g * b0 + aC1.g * b1 + aC2.g * b2);
-				interpolatedColour.b = (aC0.b * b0 + aC1.b * b1 + aC2.b * b2);
-
-				// Set the pixel at the current coordinates to the specified color
-				aSurface.set_pixel_srgb(x, y, linear_to_srgb(interpolatedColour));
-			}
-		}
-	}
+	ColorPlane planes[3];
+	if( make_color_planes( planes, aP0, aP1, aP2, aC0, aC1, aC2 ) )
+		rasterize_triangle_interp( aSurface, surface_rect_( aSurface ), aP0, aP1, aP2, planes );
+}
+
+
+bool make_color_planes( ColorPlane aPlanes[3], Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorF const& aC0, ColorF const& aC1, ColorF const& aC2 ) noexcept
+{
+	double const x0 = aP0.x, y0 = aP0.y;
+	double const dx1 = double(aP1.x) - x0, dy1 = double(aP1.y) - y0;
+	double const dx2 = double(aP2.x) - x0, dy2 = double(aP2.y) - y0;
+
+	double const area = dx1*dy2 - dx2*dy1;
+	if( !(area != 0.0) || !std::isfinite( area ) )
+		return false;
+
+	auto const plane = [&] (float aV0, float aV1, float aV2) {
+		double const d1 = double(aV1) - aV0, d2 = double(aV2) - aV0;
+		double const ddx = (d1*dy2 - d2*dy1) / area;
+		double const ddy = (d2*dx1 - d1*dx2) / area;
+
+		// Value at the origin; x and y are pixel centers
+		return ColorPlane{ float(aV0 - ddx*x0 - ddy*y0), float(ddx), float(ddy) };
+	};
+
+	aPlanes[0] = plane( aC0.r, aC1.r, aC2.r );
+	aPlanes[1] = plane( aC0.g, aC1.g, aC2.g );
+	aPlanes[2] = plane( aC0.b, aC1.b, aC2.b );
+	return true;
+}
+
+void rasterize_triangle_solid( Surface& aSurface, PixelRect const& aClip, Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorU8_sRGB aColor ) noexcept
+{
+	rasterize_triangle_( aSurface, aClip, aP0, aP1, aP2, SolidSpan_{ pack_rgbx( aColor ) } );
+}
+
+void rasterize_triangle_interp( Surface& aSurface, PixelRect const& aClip, Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorPlane const aPlanes[3] ) noexcept
+{
+	with_interp_spans_( aPlanes, [&] (auto const& aSpanFn) {
+		rasterize_triangle_( aSurface, aClip, aP0, aP1, aP2, aSpanFn );
+	} );
+}
+
+void draw_triangles_interp( Surface& aSurface, std::size_t aVertexCount, Vec2f const* aPositions, ColorF const* aColors, std::size_t aTriangleCount, std::uint32_t const* aIndices, Mat22f const& aTransform, Vec2f aTranslation )
+{
+	rasterize_triangles_interp( aSurface, surface_rect_( aSurface ), aVertexCount, aPositions, aColors, aTriangleCount, aIndices, aTransform, aTranslation );
+}
+
+void rasterize_triangles_interp( Surface& aSurface, PixelRect const& aClip, std::size_t aVertexCount, Vec2f const* aPositions, ColorF const* aColors, std::size_t aTriangleCount, std::uint32_t const* aIndices, Mat22f const& aTransform, Vec2f aTranslation )
+{
+	assert( aColors || 0 == aVertexCount );
+	rasterize_indexed_( aSurface, aClip, aVertexCount, aPositions, aColors, 0, aTriangleCount, aIndices, aTransform, aTranslation );
+}
+void rasterize_triangles_solid( Surface& aSurface, PixelRect const& aClip, std::size_t aVertexCount, Vec2f const* aPositions, std::size_t aTriangleCount, std::uint32_t const* aIndices, Mat22f const& aTransform, Vec2f aTranslation, ColorU8_sRGB aColor )
+{
+	rasterize_indexed_( aSurface, aClip, aVertexCount, aPositions, nullptr, pack_rgbx( aColor ), aTriangleCount, aIndices, aTransform, aTranslation );
+}
+
+void draw_triangle_fan_interp( Surface& aSurface, std::size_t aCount, Vec2f const* aPositions, ColorF const* aColors, Mat22f const& aTransform, Vec2f aTranslation )
+{
+	rasterize_triangle_fan_interp( aSurface, surface_rect_( aSurface ), aCount, aPositions, aColors, aTransform, aTranslation );
+}
+
+void rasterize_triangle_fan_interp( Surface& aSurface, PixelRect const& aClip, std::size_t aCount, Vec2f const* aPositions, ColorF const* aColors, Mat22f const& aTransform, Vec2f aTranslation )
+{
+	assert( aColors || 0 == aCount );
+	rasterize_fan_( aSurface, aClip, aCount, aPositions, aColors, 0, aTransform, aTranslation );
+}
+void rasterize_triangle_fan_solid( Surface& aSurface, PixelRect const& aClip, std::size_t aCount, Vec2f const* aPositions, Mat22f const& aTransform, Vec2f aTranslation, ColorU8_sRGB aColor )
+{
+	rasterize_fan_( aSurface, aClip, aCount, aPositions, nullptr, pack_rgbx( aColor ), aTransform, aTranslation );
+}
+
+bool uniform_color( ColorF const& aC0, ColorF const& aC1, ColorF const& aC2, ColorU8_sRGB& aColor ) noexcept
+{
+	auto const convert = [] (ColorF const& aColor) {
+		auto const clamp = [] (float aValue) {
+			return std::min( std::max( aValue, 0.f ), 1.f );
+		};
+		return linear_to_srgb( ColorF{ clamp( aColor.r ), clamp( aColor.g ), clamp( aColor.b ) } );
+	};
+
+	ColorU8_sRGB const c0 = convert( aC0 ), c1 = convert( aC1 ), c2 = convert( aC2 );
+	if( c0.r != c1.r || c0.g != c1.g || c0.b != c1.b || c0.r != c2.r || c0.g != c2.g || c0.b != c2.b )
+		return false;
+
+	aColor = c0;
+	return true;
+}
+
+RasterStats raster_stats() noexcept
+{
+	return gRasterStats;
+}
+void reset_raster_stats() noexcept
+{
+	gRasterStats = RasterStats{};
 }
 
 void draw_rectangle_solid( Surface& aSurface, Vec2f aMinCorner, Vec2f aMaxCorner, ColorU8_sRGB aColor )
 {
-	//TODO: your implementation goes here
-	//TODO: your implementation goes here
-	//TODO: your implementation goes here
+	// Covers the pixels whose centers lie in [min,max) along both axes, i.e.,
+	// the same pixels as two triangles that split the rectangle (same fill
+	// rule, see rasterize_triangle_()). The clipped block is filled row by
+	// row, see fill_rows().
+	PixelRect rect;
+	if( !rectangle_pixels_( rect, aSurface, aMinCorner, aMaxCorner ) )
+		return;
+
+	rect.x0 = std::max( rect.x0, 0 );
+	rect.y0 = std::max( rect.y0, 0 );
+	rect.x1 = std::min( rect.x1, int(aSurface.get_width()) );
+	rect.y1 = std::min( rect.y1, int(aSurface.get_height()) );
+	if( rect.x0 >= rect.x1 || rect.y0 >= rect.y1 )
+		return;
 
-	//TODO: remove the following when you start your implementation
-	(void)aSurface; // Avoid warnings about unused arguments until the function
-	(void)aMinCorner;   // is properly implemented.
-	(void)aMaxCorner;
-	(void)aColor;
+	aSurface.mark_dirty( rect );
+	fill_rows( pixel_ptr_( aSurface, rect.x0, rect.y0 ), 
+		std::ptrdiff_t(aSurface.get_pitch() / sizeof(PixelRGBx32)),
+		rect.x1 - rect.x0, rect.y1 - rect.y0,
+		pack_rgbx( aColor )
+	);
 }
 
 void draw_rectangle_outline( Surface& aSurface, Vec2f aMinCorner, Vec2f aMaxCorner, ColorU8_sRGB aColor )
 {
-	//TODO: your implementation goes here
-	//TODO: your implementation goes here
-	//TODO: your implementation goes here
+	// The outermost pixels of draw_rectangle_solid(). The four sides are
+	// clipped and then drawn as single runs, like axis-aligned lines (see
+	// draw_line_runs_()); the corners are only written once.
+	PixelRect rect;
+	if( !rectangle_pixels_( rect, aSurface, aMinCorner, aMaxCorner ) )
+		return;
+
+	int const width = int(aSurface.get_width());
+	int const height = int(aSurface.get_height());
+
+	std::uint32_t const pixel = pack_rgbx( aColor );
+	std::ptrdiff_t const pitch = std::ptrdiff_t(aSurface.get_pitch() / sizeof(PixelRGBx32));
+
+	int const x0 = std::max( rect.x0, 0 ), x1 = std::min( rect.x1, width );
+	auto const row = [&] (int aY) {
+		if( aY >= 0 && aY < height && x0 < x1 )
+		{
+			aSurface.mark_dirty( PixelRect{ x0, aY, x1, aY+1 } );
+			fill_run_( pixel_ptr_( aSurface, x0, aY ), 1, x1 - x0, pixel );
+		}
+	};
+
+	int const y0 = std::max( rect.y0+1, 0 ), y1 = std::min( rect.y1-1, height );
+	auto const column = [&] (int aX) {
+		if( aX >= 0 && aX < width && y0 < y1 )
+		{
+			aSurface.mark_dirty( PixelRect{ aX, y0, aX+1, y1 } );
+			fill_run_( pixel_ptr_( aSurface, aX, y0 ), pitch, y1 - y0, pixel );
+		}
+	};
+
+	row( rect.y0 );
+	if( rect.y1-1 > rect.y0 )
+		row( rect.y1-1 );
+
+	column( rect.x0 );
+	if( rect.x1-1 > rect.x0 )
+		column( rect.x1-1 );
+}
+
+
+namespace
+{
+	bool setup_line_( LineSetup& aLine, int aWidth, int aHeight, float aX0, float aY0, float aX1, float aY1 ) noexcept
+	{
+		// End points are converted to 24.8 fixed point once; everything
+		// after this is exact integer arithmetic. Pixel (x,y) covers the
+		// area [x,x+1) x [y,y+1). The line covers the pixels containing its
+		// end points and every pixel column (x-major) or row (y-major) in
+		// between. In each, it is sampled at the pixel center, and the
+		// pixel containing the sample is drawn.
+		std::int64_t x0, y0, x1, y1;
+		if( !to_fixed_( x0, y0, x1, y1, aX0, aY0, aX1, aY1 ) )
+			return false;
+
+		std::int64_t const dx = x1 - x0;
+		std::int64_t const dy = y1 - y0;
+
+		// Work in terms of the major axis (u) and the minor axis (v).
+		bool const xmajor = std::abs( dx ) >= std::abs( dy );
+
+		std::int64_t const fu0 = xmajor ? x0 : y0;
+		std::int64_t const fv0 = xmajor ? y0 : x0;
+		std::int64_t const du = xmajor ? dx : dy;
+		std::int64_t const dv = xmajor ? dy : dx;
+
+		int const su = du < 0 ? -1 : 1;
+		int const sv = dv < 0 ? -1 : 1;
+
+		// Pixel columns range from u0 to the column of the end point.
+		std::int64_t const u0 = fu0 >> kFixedShift;
+		std::int64_t const len = su * (((fu0+du) >> kFixedShift) - u0);
+
+		// Minor pixel coordinate of the i-th column's sample:
+		//   v(i) = floor( fv0 + (fu(i) - fu0) * dv/du )
+		//   fu(i) = (u0 + su*i)*kFixedOne + kFixedHalf
+		// This is written as v(i) = vb + sv*floor( (num0 + i*inc) / den ),
+		// with num0 >= 0 and inc >= 0, which is the form that LineSetup
+		// uses. For sv < 0, the floor() is mirrored: -floor(-n/d) =
+		// floor( (n+d-1)/d ).
+		std::int64_t vb = fv0 >> kFixedShift;
+		std::int64_t const adu = std::abs( du );
+		std::int64_t const adv = std::abs( dv );
+
+		std::int64_t num0, inc, den;
+		if( 0 == adu )
+		{
+			// Both end points are at the same position
+			num0 = 0;
+			inc = 0;
+			den = 1;
+		}
+		else
+		{
+			std::int64_t const e0 = su * ((u0*kFixedOne + kFixedHalf) - fu0);
+			std::int64_t const n0 = (fv0 - vb*kFixedOne)*adu + e0*dv;
+
+			den = kFixedOne * adu;
+			inc = kFixedOne * adv;
+			num0 = sv > 0 ? n0 : den-1 - n0;
+
+			// The first sample is within half a pixel of the start point,
+			// so num0/den is in [-1,2). Normalize it to [0,1); this saves a
+			// division below for lines that start inside the surface.
+			// (Written without branches, as they would be unpredictable.)
+			std::int64_t const adjust = int(num0 >= den) - int(num0 < 0);
+			num0 -= adjust*den;
+			vb += adjust*sv;
+		}
+
+		std::int64_t const ulimit = xmajor ? aWidth : aHeight;
+		std::int64_t const vlimit = xmajor ? aHeight : aWidth;
+
+		// Range of steps i in [0, len] where the major coordinate u0 + su*i
+		// is inside the surface.
+		std::int64_t ibeg = 0, iend = len;
+		if( su > 0 )
+		{
+			ibeg = std::max( ibeg, -u0 );
+			iend = std::min( iend, ulimit-1 - u0 );
+		}
+		else
+		{
+			ibeg = std::max( ibeg, u0 - (ulimit-1) );
+			iend = std::min( iend, u0 );
+		}
+
+		// Range of q = floor( (num0 + i*inc) / den ) where vb + sv*q is
+		// inside the surface. q(i) is non-decreasing, so this translates to
+		// another range of i.
+		std::int64_t const qlo = sv > 0 ? -vb : vb - (vlimit-1);
+		std::int64_t const qhi = sv > 0 ? vlimit-1 - vb : vb;
+
+		if( inc > 0 )
+		{
+			// Only divide if the line actually leaves the surface.
+			if( num0 + ibeg*inc < qlo*den )
+				ibeg = ceil_div_( qlo*den - num0, inc );
+			if( num0 + iend*inc >= (qhi+1)*den )
+				iend = floor_div_( (qhi+1)*den - num0 - 1, inc );
+		}
+		else 
+		{
+			std::int64_t const q = floor_div_( num0, den );
+			if( q < qlo || q > qhi )
+				return false;
+		}
+
+		if( ibeg > iend )
+			return false;
+
+		// Start at the first visible pixel
+		std::int64_t const num = num0 + ibeg*inc;
+		std::int64_t const q = ibeg > 0 ? floor_div_( num, den ) : 0;
+
+		std::int64_t const u = u0 + su*ibeg;
+		std::int64_t const v = vb + sv*q;
+
+		aLine.x = int(xmajor ? u : v);
+		aLine.y = int(xmajor ? v : u);
+		aLine.count = int(iend - ibeg + 1);
+
+		aLine.majorX = xmajor ? su : 0;
+		aLine.majorY = xmajor ? 0 : su;
+		aLine.minorX = xmajor ? 0 : sv;
+		aLine.minorY = xmajor ? sv : 0;
+
+		aLine.rem = num - q*den;
+		aLine.inc = inc;
+		aLine.den = den;
+
+		return true;
+	}
+
+	bool to_fixed_( std::int64_t& aX0, std::int64_t& aY0, std::int64_t& aX1, std::int64_t& aY1, float aFX0, float aFY0, float aFX1, float aFY1 ) noexcept
+	{
+		// The intermediate products in setup_line_() are bounded by the
+		// (squared) magnitude of the coordinates. Segments that extend
+		// beyond kMaxCoord are first cut down to that range (this keeps
+		// their direction, unlike clamping the coordinates). Such segments
+		// are far outside of any surface anyway. NaNs fail the comparison
+		// and are rejected below.
+		constexpr float lim = float(kMaxCoord);
+		if( !(std::abs( aFX0 ) <= lim && std::abs( aFY0 ) <= lim && std::abs( aFX1 ) <= lim && std::abs( aFY1 ) <= lim) )
+		{
+			double const x0 = aFX0, y0 = aFY0, x1 = aFX1, y1 = aFY1;
+			if( !(std::isfinite( x0 ) && std::isfinite( y0 ) && std::isfinite( x1 ) && std::isfinite( y1 )) )
+				return false;
+
+			// Liang-Barsky against [-lim,lim]^2
+			double const dx = x1 - x0, dy = y1 - y0;
+			double t0 = 0., t1 = 1.;
+
+			auto const clip = [&] (double aP, double aQ) {
+				if( 0. == aP )
+					return aQ >= 0.;
+
+				double const r = aQ / aP;
+				if( aP < 0. )
+					t0 = std::max( t0, r );
+				else
+					t1 = std::min( t1, r );
+				return t0 <= t1;
+			};
+
+			if( !(clip( -dx, x0 + lim ) && clip( dx, lim - x0 ) && clip( -dy, y0 + lim ) && clip( dy, lim - y0 )) )
+				return false;
+
+			aFX1 = float(std::clamp( x0 + t1*dx, -double(lim), double(lim) ));
+			aFY1 = float(std::clamp( y0 + t1*dy, -double(lim), double(lim) ));
+			aFX0 = float(std::clamp( x0 + t0*dx, -double(lim), double(lim) ));
+			aFY0 = float(std::clamp( y0 + t0*dy, -double(lim), double(lim) ));
+		}
 
-	//TODO: remove the following when you start your implementation
-	(void)aSurface; // Avoid warnings about unused arguments
-	(void)aMinCorner;
-	(void)aMaxCorner;
-	(void)aColor;
+		aX0 = round_fixed_( aFX0 );
+		aY0 = round_fixed_( aFY0 );
+		aX1 = round_fixed_( aFX1 );
+		aY1 = round_fixed_( aFY1 );
+		return true;
+	}
+	std::int64_t round_fixed_( float aValue ) noexcept
+	{
+		// Round to the nearest 1/kFixedOne, i.e., floor( v + 1/2 ) with v =
+		// aValue*kFixedOne. This equals floor( (floor(2v) + 1) / 2 ), and
+		// 2v is exact in floating point. std::llrint() and std::floor() are
+		// library calls without SSE4.1, while the truncating conversion is
+		// a single instruction.
+		float const scaled = aValue * float(2*kFixedOne);
+		auto trunc = std::int64_t(scaled);
+		if( float(trunc) > scaled )
+			--trunc;
+
+		return (trunc + 1) >> 1;
+	}
+
+	void draw_line_runs_( Surface& aSurface, LineSetup const& aLine, std::uint32_t aPixel ) noexcept
+	{
+		// Run-slice Bresenham: instead of stepping one pixel at a time, work
+		// out the length of each run of pixels along the major axis and fill
+		// the whole run at once. For x-major lines, runs are contiguous in
+		// memory; for y-major lines, they are strided by the surface pitch.
+		assert( aLine.count > 0 );
+
+		auto const pitch = std::ptrdiff_t(aSurface.get_pitch() / sizeof(PixelRGBx32));
+		std::ptrdiff_t const majorStride = aLine.majorX + aLine.majorY*pitch;
+		std::ptrdiff_t const minorStride = aLine.minorX + aLine.minorY*pitch;
+
+		mark_line_( aSurface, aLine );
+
+		std::uint32_t* ptr = pixel_ptr_( aSurface, aLine.x, aLine.y );
+
+		// Axis aligned: a single run. Diagonal: a single strided "run" that
+		// steps along both axes every pixel.
+		if( 0 == aLine.inc )
+		{
+			fill_run_( ptr, majorStride, aLine.count, aPixel );
+			return;
+		}
+		if( aLine.inc == aLine.den )
+		{
+			fill_run_( ptr, majorStride + minorStride, aLine.count, aPixel );
+			return;
+		}
+
+		// The run loop is instantiated separately for contiguous runs (x-major
+		// lines, either direction) and strided runs (y-major lines). The
+		// choice is made once per line instead of once per run.
+		switch( majorStride )
+		{
+			case 1: fill_line_runs_<1>( ptr, majorStride, minorStride, aLine, aPixel ); break;
+			case -1: fill_line_runs_<-1>( ptr, majorStride, minorStride, aLine, aPixel ); break;
+			default: fill_line_runs_<0>( ptr, majorStride, minorStride, aLine, aPixel ); break;
+		}
+	}
+
+	template< int tMajorStride >
+	void fill_line_runs_( std::uint32_t* aPtr, std::ptrdiff_t aMajorStride, std::ptrdiff_t aMinorStride, LineSetup const& aLine, std::uint32_t aPixel ) noexcept
+	{
+		assert( 0 == tMajorStride || tMajorStride == aMajorStride );
+		std::ptrdiff_t const majorStride = 0 != tMajorStride ? tMajorStride : aMajorStride;
+
+		// The first run depends on where the clipped line starts. After the
+		// first minor step, the remainder is smaller than inc, and each run
+		// is either whole or whole+1 pixels long.
+		std::int64_t const whole = aLine.den / aLine.inc;
+		std::int64_t const part = aLine.den % aLine.inc;
+
+		auto rem = aLine.rem;
+		auto run = ceil_div_( aLine.den - rem, aLine.inc );
+
+		int left = aLine.count;
+		while( true )
+		{
+			int const count = int(std::min<std::int64_t>( run, left ));
+			if( 1 == tMajorStride )
+			{
+				std::fill_n( aPtr, count, aPixel );
+			}
+			else if( -1 == tMajorStride )
+			{
+				std::fill_n( aPtr - (count-1), count, aPixel );
+			}
+			else
+			{
+				for( int i = 0; i < count; ++i )
+					aPtr[i*majorStride] = aPixel;
+			}
+
+			left -= count;
+			if( 0 == left )
+				break;
+
+			aPtr += count*majorStride + aMinorStride;
+
+			rem += run*aLine.inc - aLine.den;
+			run = whole + (rem < part ? 1 : 0);
+		}
+	}
+
+	bool rectangle_pixels_( PixelRect& aRect, Surface const& aSurface, Vec2f aMinCorner, Vec2f aMaxCorner ) noexcept
+	{
+		// First pixel whose center is at or after aCoord. Clamping in float
+		// keeps huge (and infinite) coordinates in the range of int.
+		auto const first = [] (float aCoord, int aSize) {
+			float const pixel = std::ceil( aCoord - 0.5f );
+			return int(std::min( std::max( pixel, -1.f ), float(aSize+1) ));
+		};
+
+		float const minX = std::min( aMinCorner.x, aMaxCorner.x );
+		float const maxX = std::max( aMinCorner.x, aMaxCorner.x );
+		float const minY = std::min( aMinCorner.y, aMaxCorner.y );
+		float const maxY = std::max( aMinCorner.y, aMaxCorner.y );
+
+		// (Comparisons with NaN are false.)
+		if( !(minX <= maxX) || !(minY <= maxY) )
+			return false;
+
+		int const width = int(aSurface.get_width());
+		int const height = int(aSurface.get_height());
+
+		aRect = PixelRect{
+			first( minX, width ), first( minY, height ),
+			first( maxX, width ), first( maxY, height )
+		};
+		return aRect.x0 < aRect.x1 && aRect.y0 < aRect.y1;
+	}
+
+	std::uint32_t* pixel_ptr_( Surface& aSurface, int aX, int aY ) noexcept
+	{
+		assert( aX >= 0 && Surface::Index(aX) < aSurface.get_width() );
+		assert( aY >= 0 && Surface::Index(aY) < aSurface.get_height() );
+
+		return aSurface.get_row_ptr( Surface::Index(aY) ) + aX;
+	}
+
+	void mark_line_( Surface& aSurface, LineSetup const& aLine ) noexcept
+	{
+		int const steps = aLine.count - 1;
+		int const x0 = aLine.x + steps * (std::min( aLine.majorX, 0 ) + std::min( aLine.minorX, 0 ));
+		int const x1 = aLine.x + steps * (std::max( aLine.majorX, 0 ) + std::max( aLine.minorX, 0 ));
+		int const y0 = aLine.y + steps * (std::min( aLine.majorY, 0 ) + std::min( aLine.minorY, 0 ));
+		int const y1 = aLine.y + steps * (std::max( aLine.majorY, 0 ) + std::max( aLine.minorY, 0 ));
+
+		aSurface.mark_dirty( PixelRect{ x0, y0, x1+1, y1+1 } );
+	}
+
+	void fill_run_( std::uint32_t* aPtr, std::ptrdiff_t aStride, int aCount, std::uint32_t aPixel ) noexcept
+	{
+		if( 1 == aStride )
+		{
+			std::fill_n( aPtr, aCount, aPixel );
+		}
+		else if( -1 == aStride )
+		{
+			std::fill_n( aPtr - (aCount-1), aCount, aPixel );
+		}
+		else
+		{
+			for( int i = 0; i < aCount; ++i, aPtr += aStride )
+				*aPtr = aPixel;
+		}
+	}
+
+	template< typename tColorFn >
+	void draw_lines_( Surface& aSurface, std::size_t aCount, float const* aX0, float const* aY0, float const* aX1, float const* aY1, ELineOrder aOrder, tColorFn&& aColorFn )
+	{
+		assert( 0 == aCount || (aX0 && aY0 && aX1 && aY1) );
+
+		int const width = int(aSurface.get_width());
+		int const height = int(aSurface.get_height());
+
+		LineGroup_ group;
+		group.simd = ESimdLevel::avx2 == simd_level();
+		group.count = 0;
+
+		if( ELineOrder::submission == aOrder )
+		{
+			for( std::size_t i = 0; i < aCount; ++i )
+			{
+				LineSetup line;
+				if( setup_line_( line, width, height,
+					aX0[i], aY0[i], aX1[i], aY1[i]
+				) )
+				{
+					group_line_( aSurface, group, line, pack_rgbx( aColorFn( i ) ) );
+				}
+			}
+
+			flush_line_group_( aSurface, group );
+			return;
+		}
+
+		// Band order: set up and clip all lines first, then bucket the
+		// visible ones by the topmost row that they touch. This is a stable
+		// counting sort, so lines within a band keep their relative order.
+		constexpr int kBandShift = 6; // 64 rows per band
+		std::size_t const bandCount = std::size_t(height >> kBandShift) + 1;
+
+		struct Visible_
+		{
+			LineSetup line;
+			std::uint32_t pixel;
+			std::size_t band;
+		};
+
+		std::vector<Visible_> visible;
+		visible.reserve( aCount );
+
+		std::vector<std::size_t> bandStart( bandCount+1, 0 );
+
+		for( std::size_t i = 0; i < aCount; ++i )
+		{
+			Visible_ vis;
+			if( !setup_line_( vis.line, width, height,
+				aX0[i], aY0[i], aX1[i], aY1[i]
+			) )
+			{
+				continue;
+			}
+
+			auto const& line = vis.line;
+			auto const steps = std::int64_t(line.count-1);
+			auto const minorSteps = (line.rem + steps*line.inc) / line.den;
+			auto const lastY = line.y + steps*line.majorY + minorSteps*line.minorY;
+
+			vis.band = std::size_t(std::min<std::int64_t>( line.y, lastY ) >> kBandShift);
+			vis.pixel = pack_rgbx( aColorFn( i ) );
+
+			++bandStart[vis.band+1];
+			visible.emplace_back( vis );
+		}
+
+		for( std::size_t b = 0; b < bandCount; ++b )
+			bandStart[b+1] += bandStart[b];
+
+		std::vector<std::size_t> order( visible.size() );
+		for( std::size_t i = 0; i < visible.size(); ++i )
+			order[bandStart[visible[i].band]++] = i;
+
+		for( auto const idx : order )
+			group_line_( aSurface, group, visible[idx].line, visible[idx].pixel );
+
+		flush_line_group_( aSurface, group );
+	}
+
+	void group_line_( Surface& aSurface, LineGroup_& aGroup, LineSetup const& aLine, std::uint32_t aPixel ) noexcept
+	{
+		// Short lines are collected into groups for the multi-line kernel.
+		// A long line is drawn directly, but only after the pending group,
+		// so that the lines are still drawn in order.
+		if( aGroup.simd && line_fits_lanes( aLine ) )
+		{
+			mark_line_( aSurface, aLine );
+
+			aGroup.lines[aGroup.count] = aLine;
+			aGroup.pixels[aGroup.count] = aPixel;
+
+			if( ++aGroup.count == kLineLanes )
+				flush_line_group_( aSurface, aGroup );
+
+			return;
+		}
+
+		flush_line_group_( aSurface, aGroup );
+		draw_line_runs_( aSurface, aLine, aPixel );
+	}
+	void flush_line_group_( Surface& aSurface, LineGroup_& aGroup ) noexcept
+	{
+		if( 0 == aGroup.count )
+			return;
+
+#		if DRAW2D_X86
+		draw_lines_avx2( aSurface, aGroup.count, aGroup.lines, aGroup.pixels );
+#		else
+		for( std::size_t i = 0; i < aGroup.count; ++i )
+			draw_line_runs_( aSurface, aGroup.lines[i], aGroup.pixels[i] );
+#		endif
+
+		aGroup.count = 0;
+	}
+
+	int coverage_( double aFraction ) noexcept
+	{
+		// Note: the end point fractions may be off by a rounding error, so
+		// they aren't strictly in [0,1]. This doesn't matter after rounding.
+		return int(aFraction * kCoverageOne + 0.5);
+	}
+
+	void blend_linear_( std::uint8_t* aPixel, std::uint16_t const aColorLinear[3], int aCoverage ) noexcept
+	{
+		assert( aCoverage >= 0 && aCoverage <= kCoverageOne );
+		if( 0 == aCoverage )
+			return;
+
+		// RGBx byte order, see Surface::set_pixel_srgb(). The pixel is read
+		// and written as a whole 32-bit value. (Byte-sized accesses to a
+		// local array end up going through memory, and the final 32-bit load
+		// then cannot be forwarded from the byte stores.)
+		std::uint8_t bytes[4];
+		std::memcpy( bytes, aPixel, sizeof(bytes) );
+
+		// The results lie between the destination and the color value, so
+		// they stay in [0,kSrgbLutSize).
+		auto const mix = [aCoverage] (std::uint8_t aDst, int aColor) {
+			int const dst = linear_from_srgb_lut12( aDst );
+			int const mixed = dst + (((aColor - dst) * aCoverage) >> kCoverageShift);
+			return linear_to_srgb_lut12( std::uint16_t(mixed) );
+		};
+
+		std::uint8_t const result[4] = {
+			mix( bytes[0], aColorLinear[0] ),
+			mix( bytes[1], aColorLinear[1] ),
+			mix( bytes[2], aColorLinear[2] ),
+			bytes[3]
+		};
+
+		std::memcpy( aPixel, result, sizeof(result) );
+	}
+
+	template< typename tSpanFn >
+	void rasterize_triangle_( Surface& aSurface, PixelRect const& aClip, Vec2f aP0, Vec2f aP1, Vec2f aP2, tSpanFn&& aSpanFn )
+	{
+		Vec2f const verts[3] = { aP0, aP1, aP2 };
+
+		bool inside = true;
+		for( auto const& v : verts )
+		{
+			if( !std::isfinite( v.x ) || !std::isfinite( v.y ) )
+				return;
+
+			inside = inside && std::abs( v.x ) <= kGuardCoord && std::abs( v.y ) <= kGuardCoord;
+		}
+
+		if( inside )
+		{
+			std::int64_t const x[3] = { round_fixed_( aP0.x ), round_fixed_( aP1.x ), round_fixed_( aP2.x ) };
+			std::int64_t const y[3] = { round_fixed_( aP0.y ), round_fixed_( aP1.y ), round_fixed_( aP2.y ) };
+			rasterize_fixed_triangle_( aSurface, aClip, x, y, aSpanFn );
+			return;
+		}
+
+		// Clip against the guard band (Sutherland-Hodgman), one side at a
+		// time. The result is a convex polygon with at most 7 vertices,
+		// which is drawn as a fan. The fan's triangles share edges, so the
+		// fill rule makes sure that no pixel is drawn twice.
+		struct Point_
+		{
+			double x, y;
+		};
+
+		Point_ poly[8], temp[8];
+		std::size_t count = 3;
+		for( std::size_t i = 0; i < 3; ++i )
+			poly[i] = Point_{ verts[i].x, verts[i].y };
+
+		for( int side = 0; side < 4 && count > 0; ++side )
+		{
+			// Signed distance to the guard band's side; inside if >= 0.
+			auto const dist = [side] (Point_ const& aP) {
+				switch( side )
+				{
+					case 0: return aP.x + kGuardCoord;
+					case 1: return kGuardCoord - aP.x;
+					case 2: return aP.y + kGuardCoord;
+					default: return kGuardCoord - aP.y;
+				}
+			};
+
+			std::size_t out = 0;
+			for( std::size_t i = 0; i < count; ++i )
+			{
+				Point_ const& cur = poly[i];
+				Point_ const& next = poly[(i+1) % count];
+
+				double const dc = dist( cur ), dn = dist( next );
+				if( dc >= 0.0 )
+					temp[out++] = cur;
+				if( (dc >= 0.0) != (dn >= 0.0) )
+				{
+					double const t = dc / (dc - dn);
+					temp[out++] = Point_{ cur.x + t*(next.x - cur.x), cur.y + t*(next.y - cur.y) };
+				}
+			}
+
+			std::copy_n( temp, out, poly );
+			count = out;
+		}
+
+		if( count < 3 )
+			return;
+
+		std::int64_t x[8], y[8];
+		for( std::size_t i = 0; i < count; ++i )
+		{
+			x[i] = round_fixed_( float(poly[i].x) );
+			y[i] = round_fixed_( float(poly[i].y) );
+		}
+
+		for( std::size_t i = 1; i+1 < count; ++i )
+		{
+			std::int64_t const tx[3] = { x[0], x[i], x[i+1] };
+			std::int64_t const ty[3] = { y[0], y[i], y[i+1] };
+			rasterize_fixed_triangle_( aSurface, aClip, tx, ty, aSpanFn );
+		}
+	}
+
+	template< typename tRasterFn >
+	void with_interp_shader_( tRasterFn&& aRasterFn )
+	{
+#		if DRAW2D_TRIANGLE_AVX2
+		if( ESimdLevel::avx2 == simd_level() )
+		{
+			aRasterFn( [] (std::uint32_t* aRow, int aX0, int aX1, int aY, ColorPlane const aPlanes[3]) {
+				shade_span_interp_avx2( aRow, aX0, aX1, aY, aPlanes );
+			} );
+			return;
+		}
+#		endif // ~ DRAW2D_TRIANGLE_AVX2
+
+		aRasterFn( [] (std::uint32_t* aRow, int aX0, int aX1, int aY, ColorPlane const aPlanes[3]) {
+			shade_span_interp_scalar_( aRow, aX0, aX1, aY, aPlanes );
+		} );
+	}
+
+	template< typename tRasterFn >
+	void with_interp_spans_( ColorPlane const aPlanes[3], tRasterFn&& aRasterFn )
+	{
+		with_interp_shader_( [&] (auto const& aShade) {
+			aRasterFn( [&aShade, aPlanes] (std::uint32_t* aRow, int aX0, int aX1, int aY) {
+				aShade( aRow, aX0, aX1, aY, aPlanes );
+			} );
+		} );
+	}
+
+	void shade_span_interp_scalar_( std::uint32_t* aRow, int aX0, int aX1, int aY, ColorPlane const aPlanes[3] ) noexcept
+	{
+		float const row[3] = {
+			row_value( aPlanes[0], aY ),
+			row_value( aPlanes[1], aY ),
+			row_value( aPlanes[2], aY )
+		};
+
+		// Pixel centers may lie slightly outside of the triangle (e.g., on an
+		// edge), so clamp to the valid range.
+		auto const channel = [&] (int aC, int aX) {
+			float const v = row[aC] + aPlanes[aC].dx * (float(aX) + 0.5f);
+			return std::min( std::max( v, 0.f ), 1.f );
+		};
+
+		for( int x = aX0; x < aX1; ++x )
+			aRow[x] = pack_rgbx( linear_to_srgb( ColorF{ channel( 0, x ), channel( 1, x ), channel( 2, x ) } ) );
+	}
+
+	FanEdge_ make_fan_edge_( std::int64_t aX0, std::int64_t aY0, std::int64_t aX1, std::int64_t aY1, std::int64_t aPX, std::int64_t aPY ) noexcept
+	{
+		// Same edge function and top-left bias as in rasterize_fixed_triangle_()
+		std::int64_t const dx = aX1 - aX0, dy = aY1 - aY0;
+		bool const topLeft = dy < 0 || (0 == dy && dx > 0);
+
+		return FanEdge_{
+			dx*(aPY - aY0) - dy*(aPX - aX0) - (topLeft ? 0 : 1),
+			-dy * kFixedOne,
+			dx * kFixedOne
+		};
+	}
+
+	void fan_edge_bound_( FanEdge_ const& aEdge, int aRow, std::int64_t& aBound, bool& aIsBegin ) noexcept
+	{
+		// Pixels where the edge function is non-negative; same divisions as in
+		// rasterize_fixed_triangle_(). Along a row, this is either the pixels
+		// from some column on (aIsBegin), or those before some column.
+		std::int64_t const e = aEdge.e + aEdge.stepY * aRow;
+		if( aEdge.stepX > 0 )
+		{
+			aIsBegin = true;
+			aBound = e < 0 ? ceil_div_( -e, aEdge.stepX ) : 0;
+		}
+		else if( aEdge.stepX < 0 )
+		{
+			aIsBegin = false;
+			aBound = e < 0 ? 0 : e / -aEdge.stepX + 1;
+		}
+		else
+		{
+			// Horizontal: all pixels (from column 0 on) or none (before 0)
+			aIsBegin = e >= 0;
+			aBound = 0;
+		}
+	}
+
+	template< typename tSpanFn >
+	void rasterize_fixed_triangle_( Surface& aSurface, PixelRect const& aClip, std::int64_t const aX[3], std::int64_t const aY[3], tSpanFn&& aSpanFn )
+	{
+		// Edge function of the edge from a to b:
+		//   E(p) = (bx-ax)*(py-ay) - (by-ay)*(px-ax)
+		// With the vertices ordered such that the (doubled) signed area is
+		// positive, the interior is where all three edge functions are
+		// positive. Degenerate triangles have zero area and cover nothing.
+		std::int64_t x[3] = { aX[0], aX[1], aX[2] };
+		std::int64_t y[3] = { aY[0], aY[1], aY[2] };
+
+		std::int64_t const area = (x[1]-x[0])*(y[2]-y[0]) - (y[1]-y[0])*(x[2]-x[0]);
+		if( 0 == area )
+			return;
+
+		if( area < 0 )
+		{
+			std::swap( x[1], x[2] );
+			std::swap( y[1], y[2] );
+		}
+
+		// Pixels whose centers lie within the bounding box, clipped to
+		// aClip. Coverage is decided per pixel center, so clipping does not
+		// change which pixels are covered.
+		auto const minX = std::min( { x[0], x[1], x[2] } ), maxX = std::max( { x[0], x[1], x[2] } );
+		auto const minY = std::min( { y[0], y[1], y[2] } ), maxY = std::max( { y[0], y[1], y[2] } );
+
+		auto const xBegin = int(std::max<std::int64_t>( ceil_div_( minX - kFixedHalf, kFixedOne ), aClip.x0 ));
+		auto const xEnd = int(std::min<std::int64_t>( floor_div_( maxX - kFixedHalf, kFixedOne ) + 1, aClip.x1 ));
+		auto const yBegin = int(std::max<std::int64_t>( ceil_div_( minY - kFixedHalf, kFixedOne ), aClip.y0 ));
+		auto const yEnd = int(std::min<std::int64_t>( floor_div_( maxY - kFixedHalf, kFixedOne ) + 1, aClip.y1 ));
+
+		if( xBegin >= xEnd || yBegin >= yEnd )
+			return;
+
+		aSurface.mark_dirty( PixelRect{ xBegin, yBegin, xEnd, yEnd } );
+
+		// Edge function values at the first pixel center, and their steps in
+		// x and y. Top-left rule: pixel centers exactly on an edge belong to
+		// the triangle only for top edges (horizontal, interior below) and
+		// left edges (interior to the right). The bias turns the "> 0" test
+		// for the other edges into ">= 0".
+		std::int64_t row[3], stepX[3], stepY[3];
+
+		std::int64_t const px = std::int64_t(xBegin)*kFixedOne + kFixedHalf;
+		std::int64_t const py = std::int64_t(yBegin)*kFixedOne + kFixedHalf;
+
+		for( int i = 0; i < 3; ++i )
+		{
+			int const j = (i+1) % 3;
+			std::int64_t const dx = x[j] - x[i], dy = y[j] - y[i];
+
+			bool const topLeft = dy < 0 || (0 == dy && dx > 0);
+
+			row[i] = dx*(py - y[i]) - dy*(px - x[i]) - (topLeft ? 0 : 1);
+			stepX[i] = -dy * kFixedOne;
+			stepY[i] = dx * kFixedOne;
+		}
+
+		// Coarse level: bands of kRasterBlock rows across the (clipped)
+		// bounding box. The edge functions are linear, so their extremes
+		// over a band are at its corners:
+		//  - if an edge is negative at all corners, the band is outside and
+		//    skipped;
+		//  - if an edge is non-negative at all corners, it is ignored for
+		//    the band's rows; if this holds for all edges, the band is
+		//    inside and its rows are covered entirely.
+		// Fine level: in the remaining (partial) bands, each row's span is
+		// found analytically from the edges that cross the band. An edge
+		// function is linear along the row, so the run of pixels where it is
+		// non-negative is found with one division instead of testing every
+		// pixel. The span is the intersection of these runs.
+		auto& stats = gRasterStats;
+		++stats.triangles;
+		stats.boundsPixels += std::uint64_t(xEnd-xBegin) * std::uint64_t(yEnd-yBegin);
+
+		int const count = xEnd - xBegin;
+		for( int by = yBegin; by < yEnd; by += kRasterBlock )
+		{
+			int const rows = std::min( kRasterBlock, yEnd - by );
+
+			int active[3], activeCount = 0;
+			bool outside = false;
+			for( int i = 0; i < 3; ++i )
+			{
+				std::int64_t const ex = stepX[i] * (count-1), ey = stepY[i] * (rows-1);
+				std::int64_t const lo = row[i] + std::min<std::int64_t>( ex, 0 ) + std::min<std::int64_t>( ey, 0 );
+				std::int64_t const hi = row[i] + std::max<std::int64_t>( ex, 0 ) + std::max<std::int64_t>( ey, 0 );
+
+				outside = outside || hi < 0;
+				if( lo < 0 )
+					active[activeCount++] = i;
+			}
+
+			if( outside )
+			{
+				++stats.bandsOutside;
+			}
+			else if( 0 == activeCount )
+			{
+				++stats.bandsInside;
+				for( int r = 0; r < rows; ++r )
+					aSpanFn( pixel_ptr_( aSurface, 0, by+r ), xBegin, xEnd, by+r );
+
+				stats.pixelsWritten += std::uint64_t(rows) * count;
+			}
+			else
+			{
+				++stats.bandsPartial;
+				stats.edgeTests += std::uint64_t(rows) * activeCount;
+
+				std::int64_t e[3] = { row[0], row[1], row[2] };
+				for( int r = 0; r < rows; ++r )
+				{
+					std::int64_t spanBegin = 0, spanEnd = count;
+					for( int k = 0; k < activeCount; ++k )
+					{
+						int const i = active[k];
+						if( stepX[i] > 0 )
+						{
+							if( e[i] < 0 )
+								spanBegin = std::max( spanBegin, ceil_div_( -e[i], stepX[i] ) );
+						}
+						else if( stepX[i] < 0 )
+						{
+							spanEnd = e[i] < 0 ? 0 : std::min( spanEnd, e[i] / -stepX[i] + 1 );
+						}
+						else if( e[i] < 0 )
+						{
+							spanEnd = 0;
+						}
+
+						e[i] += stepY[i];
+					}
+
+					if( spanBegin < spanEnd )
+					{
+						stats.pixelsWritten += std::uint64_t(spanEnd - spanBegin);
+						aSpanFn( pixel_ptr_( aSurface, 0, by+r ), xBegin + int(spanBegin), xBegin + int(spanEnd), by+r );
+					}
+				}
+			}
+
+			for( int i = 0; i < 3; ++i )
+				row[i] += stepY[i] * rows;
+		}
+	}
+
+	void rasterize_indexed_( Surface& aSurface, PixelRect const& aClip, std::size_t aVertexCount, Vec2f const* aPositions, ColorF const* aColors, std::uint32_t aPixel, std::size_t aTriangleCount, std::uint32_t const* aIndices, Mat22f const& aTransform, Vec2f aTranslation )
+	{
+		assert( aPositions || 0 == aVertexCount );
+		assert( aIndices || 0 == aTriangleCount );
+
+		// Transform each vertex once. Vertices within the guard band are also
+		// snapped to fixed point here, so triangles that share a vertex (and
+		// thus its edges) share that part of the setup. Triangles with a vertex
+		// outside of the guard band take the general path, which clips them.
+		// The vertex buffer is kept per thread and reused (fans are drawn as
+		// one batch each, so this would otherwise allocate for every fan).
+		thread_local std::vector<BatchVertex_> verts;
+		verts.resize( aVertexCount );
+		for( std::size_t i = 0; i < aVertexCount; ++i )
+		{
+			Vec2f const p = aTransform * aPositions[i] + aTranslation;
+			bool const fixed = std::isfinite( p.x ) && std::isfinite( p.y )
+				&& std::abs( p.x ) <= kGuardCoord && std::abs( p.y ) <= kGuardCoord
+			;
+
+			verts[i] = BatchVertex_{ p, fixed ? round_fixed_( p.x ) : 0, fixed ? round_fixed_( p.y ) : 0, fixed };
+		}
+
+		for( std::size_t i = 0; i < aTriangleCount; ++i )
+		{
+			std::uint32_t const* const idx = aIndices + 3*i;
+			if( idx[0] >= aVertexCount || idx[1] >= aVertexCount || idx[2] >= aVertexCount )
+				continue;
+
+			BatchVertex_ const& v0 = verts[idx[0]];
+			BatchVertex_ const& v1 = verts[idx[1]];
+			BatchVertex_ const& v2 = verts[idx[2]];
+
+			ColorU8_sRGB uniform;
+			if( !aColors )
+			{
+				rasterize_batch_triangle_( aSurface, aClip, v0, v1, v2, SolidSpan_{ aPixel } );
+			}
+			else if( uniform_color( aColors[idx[0]], aColors[idx[1]], aColors[idx[2]], uniform ) )
+			{
+				rasterize_batch_triangle_( aSurface, aClip, v0, v1, v2, SolidSpan_{ pack_rgbx( uniform ) } );
+			}
+			else
+			{
+				ColorPlane planes[3];
+				if( !make_color_planes( planes, v0.pos, v1.pos, v2.pos, aColors[idx[0]], aColors[idx[1]], aColors[idx[2]] ) )
+					continue;
+
+				with_interp_spans_( planes, [&] (auto const& aSpanFn) {
+					rasterize_batch_triangle_( aSurface, aClip, v0, v1, v2, aSpanFn );
+				} );
+			}
+		}
+	}
+
+	template< typename tSpanFn >
+	void rasterize_batch_triangle_( Surface& aSurface, PixelRect const& aClip, BatchVertex_ const& aV0, BatchVertex_ const& aV1, BatchVertex_ const& aV2, tSpanFn&& aSpanFn )
+	{
+		if( aV0.fixed && aV1.fixed && aV2.fixed )
+		{
+			std::int64_t const x[3] = { aV0.x, aV1.x, aV2.x };
+			std::int64_t const y[3] = { aV0.y, aV1.y, aV2.y };
+			rasterize_fixed_triangle_( aSurface, aClip, x, y, aSpanFn );
+		}
+		else
+		{
+			rasterize_triangle_( aSurface, aClip, aV0.pos, aV1.pos, aV2.pos, aSpanFn );
+		}
+	}
+
+	void rasterize_fan_( Surface& aSurface, PixelRect const& aClip, std::size_t aCount, Vec2f const* aPositions, ColorF const* aColors, std::uint32_t aPixel, Mat22f const& aTransform, Vec2f aTranslation )
+	{
+		assert( aPositions || 0 == aCount );
+
+		if( aCount < 3 )
+			return;
+
+		// Vertex 0 is the center, the others form the rim. Sector i is the
+		// triangle (center, rim[i], rim[i+1]), and spoke i is the edge from the
+		// center to rim[i]. Adjacent sectors share a spoke.
+		std::size_t const rimCount = aCount-1;
+
+		// As in rasterize_indexed_(), the buffers are kept per thread and
+		// reused. (The fallback below calls rasterize_indexed_(), which has
+		// its own buffers.)
+		thread_local std::vector<Vec2f> pos;
+		thread_local std::vector<std::int64_t> fx, fy;
+		pos.resize( aCount );
+		fx.resize( aCount );
+		fy.resize( aCount );
+		for( std::size_t i = 0; i < aCount; ++i )
+		{
+			pos[i] = aTransform * aPositions[i] + aTranslation;
+
+			bool const fixed = std::isfinite( pos[i].x ) && std::isfinite( pos[i].y )
+				&& std::abs( pos[i].x ) <= kGuardCoord && std::abs( pos[i].y ) <= kGuardCoord
+			;
+
+			// Fans that reach past the guard band are rare; they are drawn as
+			// separate triangles, which are clipped individually.
+			if( !fixed )
+			{
+				thread_local std::vector<std::uint32_t> indices;
+				indices.clear();
+				for( std::size_t j = 0; j < rimCount; ++j )
+				{
+					indices.emplace_back( 0 );
+					indices.emplace_back( std::uint32_t(1+j) );
+					indices.emplace_back( std::uint32_t(1+(j+1) % rimCount) );
+				}
+
+				rasterize_indexed_( aSurface, aClip, aCount, aPositions, aColors, aPixel, rimCount, indices.data(), aTransform, aTranslation );
+				return;
+			}
+
+			fx[i] = round_fixed_( pos[i].x );
+			fy[i] = round_fixed_( pos[i].y );
+		}
+
+		// Columns and rows of pixel centers within the fan's bounding box,
+		// clipped to aClip. Edge functions are evaluated relative to the first
+		// of these pixels.
+
+		auto const minX = *std::min_element( fx.begin(), fx.end() ), maxX = *std::max_element( fx.begin(), fx.end() );
+		auto const minY = *std::min_element( fy.begin(), fy.end() ), maxY = *std::max_element( fy.begin(), fy.end() );
+
+		auto const xBegin = int(std::max<std::int64_t>( ceil_div_( minX - kFixedHalf, kFixedOne ), aClip.x0 ));
+		auto const xEnd = int(std::min<std::int64_t>( floor_div_( maxX - kFixedHalf, kFixedOne ) + 1, aClip.x1 ));
+		auto const yBegin = int(std::max<std::int64_t>( ceil_div_( minY - kFixedHalf, kFixedOne ), aClip.y0 ));
+		auto const yEnd = int(std::min<std::int64_t>( floor_div_( maxY - kFixedHalf, kFixedOne ) + 1, aClip.y1 ));
+
+		if( xBegin >= xEnd || yBegin >= yEnd )
+			return;
+
+		aSurface.mark_dirty( PixelRect{ xBegin, yBegin, xEnd, yEnd } );
+
+		std::int64_t const px = std::int64_t(xBegin)*kFixedOne + kFixedHalf;
+		std::int64_t const py = std::int64_t(yBegin)*kFixedOne + kFixedHalf;
+
+		// Each spoke's edge function is set up once. Per row, the pixels where
+		// it is non-negative are found once, too; the sector on the other side
+		// of the spoke covers exactly the remaining pixels (the edge function
+		// of the reversed edge is negated, and the fill rule assigns pixels on
+		// the edge to exactly one side).
+		struct Spoke_
+		{
+			FanEdge_ edge;
+			int row;
+			bool isBegin;
+			std::int64_t bound;
+		};
+
+		thread_local std::vector<Spoke_> spokes;
+		spokes.resize( rimCount );
+		for( std::size_t i = 0; i < rimCount; ++i )
+			spokes[i] = Spoke_{ make_fan_edge_( fx[0], fy[0], fx[1+i], fy[1+i], px, py ), -1, false, 0 };
+
+		// Sectors are set up like rasterize_fixed_triangle_() would set up the
+		// triangle (vertex order, orientation and row range), so that the scan
+		// covers and shades exactly the same pixels as drawing the sectors as
+		// separate triangles with draw_triangle_interp().
+		struct Sector_
+		{
+			bool solid;
+			std::uint32_t pixel;
+			ColorPlane planes[3];
+			int rowBegin, rowEnd;
+			std::size_t forward, reversed; // spokes
+			FanEdge_ rim;
+		};
+
+		thread_local std::vector<Sector_> sectors;
+		sectors.clear();
+
+		for( std::size_t i = 0; i < rimCount; ++i )
+		{
+			std::size_t const a = 1+i, b = 1+(i+1) % rimCount;
+
+			std::int64_t const area = (fx[a]-fx[0])*(fy[b]-fy[0]) - (fy[a]-fy[0])*(fx[b]-fx[0]);
+			if( 0 == area )
+				continue;
+
+			Sector_ sector;
+			sector.solid = !aColors;
+			sector.pixel = aPixel;
+
+			ColorU8_sRGB uniform;
+			if( aColors && uniform_color( aColors[0], aColors[a], aColors[b], uniform ) )
+			{
+				sector.solid = true;
+				sector.pixel = pack_rgbx( uniform );
+			}
+			else if( aColors && !make_color_planes( sector.planes, pos[0], pos[a], pos[b], aColors[0], aColors[a], aColors[b] ) )
+			{
+				continue;
+			}
+
+			auto const sMinY = std::min( { fy[0], fy[a], fy[b] } ), sMaxY = std::max( { fy[0], fy[a], fy[b] } );
+			sector.rowBegin = int(std::max<std::int64_t>( ceil_div_( sMinY - kFixedHalf, kFixedOne ), yBegin ));
+			sector.rowEnd = int(std::min<std::int64_t>( floor_div_( sMaxY - kFixedHalf, kFixedOne ) + 1, yEnd ));
+			if( sector.rowBegin >= sector.rowEnd )
+				continue;
+
+			// Positive area: edges center->a, a->b, b->center. Otherwise, the
+			// triangle is flipped to center->b, b->a, a->center.
+			if( area > 0 )
+			{
+				sector.forward = i;
+				sector.reversed = (i+1) % rimCount;
+				sector.rim = make_fan_edge_( fx[a], fy[a], fx[b], fy[b], px, py );
+			}
+			else
+			{
+				sector.forward = (i+1) % rimCount;
+				sector.reversed = i;
+				sector.rim = make_fan_edge_( fx[b], fy[b], fx[a], fy[a], px, py );
+			}
+
+			sectors.emplace_back( sector );
+		}
+
+		// Walk the rows top to bottom. Within a row, sectors are visited in fan
+		// order, which is also the order in which the triangles would be drawn
+		// (this only matters if the fan winds around more than once).
+		auto& stats = gRasterStats;
+		stats.triangles += sectors.size();
+		stats.boundsPixels += std::uint64_t(xEnd-xBegin) * std::uint64_t(yEnd-yBegin);
+
+		std::int64_t const count = xEnd - xBegin;
+
+		with_interp_shader_( [&] (auto const& aShade) {
+			for( int y = yBegin; y < yEnd; ++y )
+			{
+				int const row = y - yBegin;
+				std::uint32_t* const rowPtr = pixel_ptr_( aSurface, 0, y );
+
+				for( auto const& sector : sectors )
+				{
+					if( y < sector.rowBegin || y >= sector.rowEnd )
+						continue;
+
+					auto const spoke = [&] (std::size_t aIndex) -> Spoke_ const& {
+						auto& sp = spokes[aIndex];
+						if( row != sp.row )
+						{
+							fan_edge_bound_( sp.edge, row, sp.bound, sp.isBegin );
+							sp.row = row;
+							++stats.edgeTests;
+						}
+						return sp;
+					};
+
+					std::int64_t spanBegin = 0, spanEnd = count;
+
+					auto const& fwd = spoke( sector.forward );
+					if( fwd.isBegin )
+						spanBegin = std::max( spanBegin, fwd.bound );
+					else
+						spanEnd = std::min( spanEnd, fwd.bound );
+
+					auto const& rev = spoke( sector.reversed );
+					if( rev.isBegin )
+						spanEnd = std::min( spanEnd, rev.bound );
+					else
+						spanBegin = std::max( spanBegin, rev.bound );
+
+					if( spanBegin >= spanEnd )
+						continue;
+
+					std::int64_t bound;
+					bool isBegin;
+					fan_edge_bound_( sector.rim, row, bound, isBegin );
+					++stats.edgeTests;
+
+					if( isBegin )
+						spanBegin = std::max( spanBegin, bound );
+					else
+						spanEnd = std::min( spanEnd, bound );
+
+					if( spanBegin < spanEnd )
+					{
+						stats.pixelsWritten += std::uint64_t(spanEnd - spanBegin);
+						if( sector.solid )
+							fill_run_( rowPtr + xBegin + spanBegin, 1, int(spanEnd - spanBegin), sector.pixel );
+						else
+							aShade( rowPtr, xBegin + int(spanBegin), xBegin + int(spanEnd), y, sector.planes );
+					}
+				}
+			}
+		} );
+	}
+
+	PixelRect surface_rect_( Surface const& aSurface ) noexcept
+	{
+		return PixelRect{ 0, 0, int(aSurface.get_width()), int(aSurface.get_height()) };
+	}
+
+	void set_bits_( std::uint64_t* aMask, int aBegin, int aEnd ) noexcept
+	{
+		assert( 0 <= aBegin && aBegin < aEnd );
+
+		auto const firstWord = aBegin / 64, lastWord = (aEnd-1) / 64;
+		auto const head = ~std::uint64_t(0) << (aBegin % 64);
+		auto const tail = ~std::uint64_t(0) >> (63 - (aEnd-1) % 64);
+
+		if( firstWord == lastWord )
+		{
+			aMask[firstWord] |= head & tail;
+			return;
+		}
+
+		aMask[firstWord] |= head;
+		for( int i = firstWord+1; i < lastWord; ++i )
+			aMask[i] = ~std::uint64_t(0);
+		aMask[lastWord] |= tail;
+	}
+
+	int count_trailing_zeros_( std::uint64_t aValue ) noexcept
+	{
+		assert( 0 != aValue );
+#		if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64( &index, aValue );
+		return int(index);
+#		else
+		return __builtin_ctzll( aValue );
+#		endif
+	}
+
+	std::int64_t floor_div_( std::int64_t aNum, std::int64_t aDen ) noexcept
+	{
+		assert( aDen > 0 );
+		std::int64_t const q = aNum / aDen;
+		return (aNum % aDen < 0) ? q-1 : q;
+	}
+	std::int64_t ceil_div_( std::int64_t aNum, std::int64_t aDen ) noexcept
+	{
+		assert( aDen > 0 );
+		std::int64_t const q = aNum / aDen;
+		return (aNum % aDen > 0) ? q+1 : q;
+	}
 }
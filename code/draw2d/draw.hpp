@@ -6,10 +6,14 @@
 // For CW1, the draw.hpp file must remain exactly as it is. In particular, you
 // must not change any of the function prototypes in this header.
 
+#include <cstddef>
+#include <cstdint>
+
 #include "forward.hpp"
 #include "color.hpp"
 
 #include "../vmlib/vec2.hpp"
+#include "../vmlib/mat22.hpp"
 
 // Coursework 1:
 void draw_line_solid(
@@ -35,8 +39,137 @@ void draw_triangle_wireframe(
 	ColorU8_sRGB
 );
 
-// From Exercise G.1
-// You can ignore these in Coursework 1
+// Batched lines:
+// Draws aCount line segments given in structure-of-arrays form. Segment i goes
+// from (aX0[i], aY0[i]) to (aX1[i], aY1[i]) and is drawn exactly like
+// draw_line_solid() would draw it. The surface setup is done once for the
+// whole batch.
+//
+// With ELineOrder::submission, segments are drawn in the order given. With
+// ELineOrder::band, segments are first sorted into horizontal bands of the
+// surface, which improves cache locality for large batches. Where segments of
+// different colors overlap, the band order may change which color ends up on
+// top.
+enum class ELineOrder
+{
+	submission,
+	band
+};
+
+void draw_lines_solid(
+	Surface&,
+	std::size_t aCount,
+	float const* aX0, float const* aY0,
+	float const* aX1, float const* aY1,
+	ColorU8_sRGB const* aColors,
+	ELineOrder = ELineOrder::submission
+);
+void draw_lines_solid(
+	Surface&,
+	std::size_t aCount,
+	float const* aX0, float const* aY0,
+	float const* aX1, float const* aY1,
+	ColorU8_sRGB,
+	ELineOrder = ELineOrder::submission
+);
+
+// Batched triangles:
+// Draws the union of aCount triangles, given as three consecutive vertices
+// each (i.e., aVertices holds 3*aCount elements). A pixel is covered by a
+// triangle if its center lies inside of it; pixel centers exactly on an edge
+// are included for left edges and excluded for right edges (and likewise for
+// top and bottom edges). Triangles that share an edge thus neither overlap
+// nor leave gaps. Each covered pixel is written exactly once, even where
+// triangles overlap (e.g., the joins of a stroke, see stroke.hpp).
+//
+// Returns the number of pixels written.
+std::size_t draw_triangles_solid(
+	Surface&,
+	std::size_t aCount,
+	Vec2f const* aVertices,
+	ColorU8_sRGB
+);
+
+// Indexed triangles:
+// Draws aTriangleCount triangles with per-vertex colors. The vertices are
+// given by aPositions[0..aVertexCount) and aColors[0..aVertexCount); triangle
+// i uses the vertices aIndices[3*i+0], aIndices[3*i+1] and aIndices[3*i+2].
+// Positions are transformed as aTransform * position + aTranslation. Each
+// triangle is drawn exactly like draw_triangle_interp() would draw it with the
+// transformed positions, but each vertex is transformed and converted to the
+// rasterizer's fixed point format only once, however many triangles share it.
+// Triangles with out-of-range indices are skipped.
+void draw_triangles_interp(
+	Surface&,
+	std::size_t aVertexCount,
+	Vec2f const* aPositions, ColorF const* aColors,
+	std::size_t aTriangleCount,
+	std::uint32_t const* aIndices,
+	Mat22f const& aTransform, Vec2f aTranslation
+);
+
+// Triangle fans:
+// Draws the fan with the aCount vertices aPositions and colors aColors (see
+// TriangleFan in shape.hpp). Vertex 0 is the center; triangle i (for i in
+// [0,aCount-1)) connects it to the vertices 1+i and 1+(i+1)%(aCount-1). The
+// result is exactly the same as drawing these triangles with
+// draw_triangles_interp(). However, the fan is scanned in a single pass from
+// top to bottom. The edges between neighbouring triangles are set up once,
+// and they are evaluated once per row for both triangles.
+void draw_triangle_fan_interp(
+	Surface&,
+	std::size_t aCount,
+	Vec2f const* aPositions, ColorF const* aColors,
+	Mat22f const& aTransform, Vec2f aTranslation
+);
+
+// Anti-aliased lines:
+// Draws a line with Xiaolin Wu's algorithm. Each pixel is blended with the line
+// color according to how much of it the line covers. Blending happens in linear
+// space, with table-driven sRGB conversions (see linear_to_srgb_lut()). Like
+// draw_line_solid(), the line covers the columns (rows, if steep) between the
+// end points. It is clipped to the surface before it is drawn, and clipping
+// does not change the pixels that remain visible.
+void draw_line_aa(
+	Surface&,
+	Vec2f aBegin, Vec2f aEnd,
+	ColorU8_sRGB
+);
+
+// Pixels [x0,x1) x [y0,y1), e.g., a scissor rectangle
+struct PixelRect
+{
+	int x0, y0, x1, y1;
+};
+
+// Triangle rasterizer statistics:
+// draw_triangle_solid(), draw_triangle_interp() and draw_triangles_solid()
+// first classify bands of kRasterBlock rows across each triangle's bounding
+// box. Bands entirely outside the triangle are skipped, and bands entirely
+// inside are filled without any edge tests. In the remaining (partial) bands,
+// each row's span is computed from the edges crossing the band, with one edge
+// test per edge and row (but no per-pixel tests). For draw_triangles_solid(),
+// pixelsWritten counts the pixels of each triangle, before overlaps are
+// merged. The counters are kept per thread; triangles drawn by a
+// TriangleBinner are counted on the threads that rasterize them.
+constexpr int kRasterBlock = 8;
+
+struct RasterStats
+{
+	std::uint64_t triangles;
+	std::uint64_t boundsPixels; // pixels in the (clipped) bounding boxes
+	std::uint64_t bandsOutside, bandsInside, bandsPartial;
+	std::uint64_t edgeTests; // per row, in partial bands
+	std::uint64_t pixelsWritten;
+};
+
+RasterStats raster_stats() noexcept;
+void reset_raster_stats() noexcept;
+
+// Axis-aligned rectangles. The solid rectangle covers the pixels whose centers
+// lie within [min,max) along both axes; these are the same pixels that two
+// triangles splitting the rectangle cover. The outline covers the outermost
+// pixels of the solid rectangle. Either corner may be the smaller one.
 void draw_rectangle_solid(
 	Surface&,
 	Vec2f aMinCorner, Vec2f aMaxCorner,
@@ -8,6 +8,7 @@ class LineStrip;
 class TriangleFan;
 
 class Surface;
+class TriangleBinner;
 
 class ImageRGBA;
 
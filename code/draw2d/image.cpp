@@ -1,8 +1,10 @@
 #include "image.hpp"
 
 #include <memory>
+#include <vector>
 #include <algorithm>
 
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <cassert>
@@ -51,55 +53,62 @@ std::unique_ptr<ImageRGBA> load_image( char const* aPath )
 
 void blit_masked( Surface& aSurface, ImageRGBA const& aImage, Vec2f aPosition )
 {
-	//TODO: your implementation goes here
-	//getting the source image width and height
-	//this is usefull for iterating through each pixel and it's used in the nested for loops
-	int blitImageWidth = aImage.get_width();
-	int blitImageHeight = aImage.get_height();
-
-	// we get through the pixels of the aImage
-	//y coordinate dominant as the better option of reading pixels linearly
-	for (int y = 0; y < blitImageHeight; ++y)
+	// Image pixel (x,y) goes to surface pixel (ox+x, oy+y), where (ox,oy) is
+	// aPosition rounded down. Pixels with alpha < 128 are skipped. The image
+	// is clipped to the surface up front, and each row is then copied as
+	// spans of opaque pixels with Surface::write_span_colors().
+	if( !std::isfinite( aPosition.x ) || !std::isfinite( aPosition.y ) )
+		return;
+
+	auto const width = std::int64_t(aSurface.get_width());
+	auto const height = std::int64_t(aSurface.get_height());
+
+	// Clamp before the conversion, such that far away positions cannot
+	// overflow.
+	auto const ox = std::int64_t(std::floor( std::clamp( aPosition.x, -float(aImage.get_width()), float(width) ) ));
+	auto const oy = std::int64_t(std::floor( std::clamp( aPosition.y, -float(aImage.get_height()), float(height) ) ));
+
+	auto const x0 = std::max<std::int64_t>( 0, -ox );
+	auto const y0 = std::max<std::int64_t>( 0, -oy );
+	auto const x1 = std::min<std::int64_t>( aImage.get_width(), width - ox );
+	auto const y1 = std::min<std::int64_t>( aImage.get_height(), height - oy );
+	if( x0 >= x1 || y0 >= y1 )
+		return;
+
+	// RGBA -> RGBx: both store r, g and b in the first three bytes, so a
+	// pixel is converted by clearing the fourth byte.
+	PixelRGBx32 const rgbMask = pack_rgbx( { 255, 255, 255 } );
+
+	std::vector<PixelRGBx32> span( std::size_t(x1 - x0) );
+
+	auto const* const image = aImage.get_image_ptr();
+	for( std::int64_t y = y0; y < y1; ++y )
 	{
-		for (int x = 0; x < blitImageWidth; ++x)
+		auto const* const src = image + 4*aImage.get_linear_index( ImageRGBA::Index(x0), ImageRGBA::Index(y) );
+		auto const dy = Surface::Index(oy + y);
+
+		std::int64_t runBegin = x0;
+		std::size_t count = 0;
+		for( std::int64_t x = x0; x < x1; ++x )
 		{
-			//retriving the pixel colour from the image
-			ColorU8_sRGB_Alpha pixelColour = aImage.get_pixel(x, y);
-
-			// here we check if the alpha value of the pixel is greater or equal to 128
-			//as the cw pdf suggests, this is alph amasking
-			//the alpha value(transparancy) is stored in the "pixelColour.a"
-			//we put the condition >=128 to make sure the ".a" value is opaque 
-			//and it's used as a mask to determine if the pixel is good to be blitted(copied)
-			//onto our surface or not
-			if (pixelColour.a >= 128)
+			auto const* const pixel = src + 4*(x - x0);
+			if( pixel[3] >= 128 )
 			{
-				// we are calculating the destination position for the blit image
-				//based on aPosition, where the image will be placed on the screen(surface) 
-				//plus the size of each pixel added
-				// I use static_cast<float>() to make sure I get the float precision and 
-				//the arithmetic is consistant
-				float blitDestX = aPosition.x + static_cast<float>(x);
-				float blitDestY = aPosition.y + static_cast<float>(y);
-
-				// we need to convert the ColorU8_sRGB_Alpha pixel to ColorU8_sRGB
-				//to be accepted by set_pixel_srgb() function, aColour
-				//again, this is similar to the original set_pixel_srgb() implementation
-				ColorU8_sRGB convertedPixel;
-				convertedPixel.r = pixelColour.r;
-				convertedPixel.g = pixelColour.g;
-				convertedPixel.b = pixelColour.b;
-
-				// per usual we have to ensure that the destination position is 
-				// within the bounds of aSurface
-				if (blitDestX >= 0 && blitDestX < aSurface.get_width() && blitDestY >= 0 && blitDestY < aSurface.get_height())
-				{
-					// we blit(copy) the pixel to the destination position on aSurface
-					// with the converted pixels
-					aSurface.set_pixel_srgb(blitDestX, blitDestY, convertedPixel);
-				}
+				PixelRGBx32 packed;
+				std::memcpy( &packed, pixel, sizeof(packed) );
+				span[count++] = packed & rgbMask;
+				continue;
 			}
+
+			if( count )
+				aSurface.write_span_colors( dy, Surface::Index(ox + runBegin), Surface::Index(ox + runBegin) + Surface::Index(count), span.data() );
+
+			runBegin = x+1;
+			count = 0;
 		}
+
+		if( count )
+			aSurface.write_span_colors( dy, Surface::Index(ox + runBegin), Surface::Index(ox + runBegin) + Surface::Index(count), span.data() );
 	}
 }
 
@@ -0,0 +1,82 @@
+#include "line-kernels.hpp"
+
+#include "cpu.hpp"
+
+#if DRAW2D_X86
+
+#include <cassert>
+
+#include <immintrin.h>
+
+#include "surface.hpp"
+
+DRAW2D_TARGET_AVX2
+void draw_lines_avx2( Surface& aSurface, std::size_t aCount, LineSetup const* aLines, std::uint32_t const* aPixels ) noexcept
+{
+	assert( aCount <= kLineLanes );
+	assert( std::uint64_t(aSurface.get_pitch()/4)*aSurface.get_height() <= 0x7fffffffu );
+
+	// Each lane steps one line. Per step, a lane records the linear index
+	// of its current pixel; the pixels are written afterwards, line by line,
+	// so that overlapping lines are resolved exactly as in the scalar code.
+	// (AVX2 has gathers but no scatters.)
+	auto const pitch = int(aSurface.get_pitch() / sizeof(std::uint32_t));
+
+	alignas(32) std::int32_t offset[kLineLanes] = {};
+	alignas(32) std::int32_t rem[kLineLanes] = {};
+	alignas(32) std::int32_t inc[kLineLanes] = {};
+	alignas(32) std::int32_t den[kLineLanes] = {};
+	alignas(32) std::int32_t major[kLineLanes] = {};
+	alignas(32) std::int32_t minor[kLineLanes] = {};
+
+	int steps = 0;
+	for( std::size_t i = 0; i < aCount; ++i )
+	{
+		auto const& line = aLines[i];
+		assert( line.count > 0 && line_fits_lanes( line ) );
+
+		offset[i] = line.y*pitch + line.x;
+		rem[i] = std::int32_t(line.rem);
+		inc[i] = std::int32_t(line.inc);
+		den[i] = std::int32_t(line.den);
+		major[i] = line.majorY*pitch + line.majorX;
+		minor[i] = line.minorY*pitch + line.minorX;
+
+		if( line.count > steps )
+			steps = line.count;
+	}
+
+	auto const one = _mm256_set1_epi32( 1 );
+
+	auto off = _mm256_load_si256( reinterpret_cast<__m256i const*>(offset) );
+	auto r = _mm256_load_si256( reinterpret_cast<__m256i const*>(rem) );
+	auto const i = _mm256_load_si256( reinterpret_cast<__m256i const*>(inc) );
+	auto const d = _mm256_load_si256( reinterpret_cast<__m256i const*>(den) );
+	auto const dm1 = _mm256_sub_epi32( d, one );
+	auto const ma = _mm256_load_si256( reinterpret_cast<__m256i const*>(major) );
+	auto const mi = _mm256_load_si256( reinterpret_cast<__m256i const*>(minor) );
+
+	alignas(32) std::int32_t indices[kLaneMaxPixels][kLineLanes];
+	for( int s = 0; s < steps; ++s )
+	{
+		_mm256_store_si256( reinterpret_cast<__m256i*>(indices[s]), off );
+
+		// off += major; rem += inc; if rem >= den: rem -= den, off += minor
+		off = _mm256_add_epi32( off, ma );
+		r = _mm256_add_epi32( r, i );
+
+		auto const step = _mm256_cmpgt_epi32( r, dm1 );
+		r = _mm256_sub_epi32( r, _mm256_and_si256( step, d ) );
+		off = _mm256_add_epi32( off, _mm256_and_si256( step, mi ) );
+	}
+
+	auto* const pixels = reinterpret_cast<std::uint32_t*>(aSurface.get_surface_ptr());
+	for( std::size_t l = 0; l < aCount; ++l )
+	{
+		auto const pixel = aPixels[l];
+		for( int s = 0; s < aLines[l].count; ++s )
+			pixels[indices[s][l]] = pixel;
+	}
+}
+
+#endif // ~ DRAW2D_X86
@@ -0,0 +1,49 @@
+#ifndef LINE_KERNELS_HPP_682CF1F6_B912_4018_8465_B63D0B6C93E3
+#define LINE_KERNELS_HPP_682CF1F6_B912_4018_8465_B63D0B6C93E3
+
+// Internal to draw2d: line set up shared between draw.cpp and the SIMD line
+// kernels. Not part of the public API.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "forward.hpp"
+
+/* Line set up for stepping along its major axis
+ *
+ * The i-th pixel of the (unclipped) line is offset by i steps along the
+ * major axis and by floor( (num0 + i*inc) / den ) steps along the minor
+ * axis. LineSetup holds this in incremental form, starting at the first
+ * visible pixel: rem is the remainder of the numerator at that pixel.
+ */
+struct LineSetup
+{
+	int x, y; // first visible pixel
+	int count; // number of visible pixels
+
+	int majorX, majorY; // step along the major axis
+	int minorX, minorY; // step along the minor axis
+
+	std::int64_t rem, inc, den;
+};
+
+// Multi-line kernels step kLineLanes lines at once, one line per lane. They
+// only accept short lines (see line_fits_lanes()); for longer lines, the
+// scalar run-slice code is faster anyway.
+constexpr std::size_t kLineLanes = 8;
+constexpr int kLaneMaxPixels = 64;
+
+inline
+bool line_fits_lanes( LineSetup const& aLine ) noexcept
+{
+	// The lanes keep rem, inc and den as 32-bit integers, and rem+inc must
+	// not overflow.
+	return aLine.count <= kLaneMaxPixels && aLine.den <= (std::int64_t(1) << 30);
+}
+
+// Draws aCount <= kLineLanes lines with AVX2. Lines are drawn in order, so
+// where they overlap, the result is identical to drawing them one by one.
+// Requires ESimdLevel::avx2 (see cpu.hpp).
+void draw_lines_avx2( Surface&, std::size_t aCount, LineSetup const*, std::uint32_t const* aPixels ) noexcept;
+
+#endif // LINE_KERNELS_HPP_682CF1F6_B912_4018_8465_B63D0B6C93E3
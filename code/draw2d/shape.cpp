@@ -1,13 +1,25 @@
 #include "shape.hpp"
 
+#include <vector>
 #include <utility>
+#include <algorithm>
 
+#include <cmath>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 
 #include "draw.hpp"
 #include "color.hpp"
+#include "binner.hpp"
 #include "surface.hpp"
+#include "triangle-kernels.hpp"
+
+namespace
+{
+	// Statistics are collected per thread, see fan_stats().
+	thread_local FanStats gFanStats{};
+}
 
 LineStrip::LineStrip( std::size_t aCount, Vec2f const* aVerts )
 	: mCount( aCount )
@@ -37,16 +49,35 @@ LineStrip& LineStrip::operator= (LineStrip&& aOther)  noexcept
 
 void LineStrip::draw( Surface& aSurface, ColorF const& aColor, Mat22f const& aRotation, Vec2f const& aTranslation ) const
 {
-	ColorU8_sRGB const color = linear_to_srgb( aColor );
+	if( mCount < 2 )
+		return;
 
-	Vec2f previous = aRotation * mVertices[0] + aTranslation;
+	ColorU8_sRGB const color = linear_to_srgb( aColor );
 
-	for( std::size_t i = 1; i < mCount; ++i )
+	// Transform all vertices once, and then submit the strip as a single
+	// batch. Segment i runs from vertex i to vertex i+1, so the end points
+	// are just the start points offset by one.
+	std::vector<float> xs( mCount ), ys( mCount );
+	for( std::size_t i = 0; i < mCount; ++i )
 	{
-		Vec2f const current = aRotation * mVertices[i] + aTranslation;
-		draw_line_solid( aSurface, previous, current, color );
-		previous = current;
+		Vec2f const v = aRotation * mVertices[i] + aTranslation;
+		xs[i] = v.x;
+		ys[i] = v.y;
 	}
+
+	draw_lines_solid( aSurface, mCount-1, xs.data(), ys.data(), xs.data()+1, ys.data()+1, color );
+}
+
+void LineStrip::draw_stroke( Surface& aSurface, ColorF const& aColor, StrokeStyle const& aStyle, Mat22f const& aRotation, Vec2f const& aTranslation ) const
+{
+	std::vector<Vec2f> points( mCount );
+	for( std::size_t i = 0; i < mCount; ++i )
+		points[i] = aRotation * mVertices[i] + aTranslation;
+
+	std::vector<Vec2f> triangles;
+	stroke_polyline( triangles, points.size(), points.data(), aStyle );
+
+	draw_triangles_solid( aSurface, triangles.size()/3, triangles.data(), linear_to_srgb( aColor ) );
 }
 
 
@@ -54,6 +85,12 @@ TriangleFan::TriangleFan( std::size_t aCount, PosAndCol const* aVerts )
 	: mCount( aCount )
 	, mVertices( nullptr )
 	, mColors( nullptr )
+	, mIndices( nullptr )
+	, mRadius( 0.f )
+	, mBoundsMin{ 0.f, 0.f }
+	, mBoundsMax{ 0.f, 0.f }
+	, mUniform( false )
+	, mUniformColor{ 0, 0, 0 }
 {
 	// Note: technically unsafe if "new" fails to allocate memory
 
@@ -65,11 +102,21 @@ TriangleFan::TriangleFan( std::size_t aCount, PosAndCol const* aVerts )
 		mVertices[i] = aVerts[i].pos;
 		mColors[i] = aVerts[i].col;
 	}
+
+	compute_bounds_();
+	compute_uniform_();
+	compute_indices_();
 }
 TriangleFan::TriangleFan( std::size_t aCount, Vec2f const* aVerts, ColorF const* aColors )
 	: mCount( aCount )
 	, mVertices( nullptr )
 	, mColors( nullptr )
+	, mIndices( nullptr )
+	, mRadius( 0.f )
+	, mBoundsMin{ 0.f, 0.f }
+	, mBoundsMax{ 0.f, 0.f }
+	, mUniform( false )
+	, mUniformColor{ 0, 0, 0 }
 {
 	assert( aVerts && aColors );
 
@@ -80,10 +127,15 @@ TriangleFan::TriangleFan( std::size_t aCount, Vec2f const* aVerts, ColorF const*
 
 	mColors = new ColorF[mCount];
 	std::memcpy( mColors, aColors, sizeof(ColorF)*mCount );
+
+	compute_bounds_();
+	compute_uniform_();
+	compute_indices_();
 }
 
 TriangleFan::~TriangleFan()
 {
+	delete [] mIndices;
 	delete [] mColors;
 	delete [] mVertices;
 }
@@ -93,33 +145,215 @@ TriangleFan::TriangleFan( TriangleFan&& aOther ) noexcept
 	: mCount( std::exchange( aOther.mCount, 0 ) )
 	, mVertices( std::exchange( aOther.mVertices, nullptr ) )
 	, mColors( std::exchange( aOther.mColors, nullptr ) )
+	, mIndices( std::exchange( aOther.mIndices, nullptr ) )
+	, mRadius( std::exchange( aOther.mRadius, 0.f ) )
+	, mBoundsMin( std::exchange( aOther.mBoundsMin, Vec2f{ 0.f, 0.f } ) )
+	, mBoundsMax( std::exchange( aOther.mBoundsMax, Vec2f{ 0.f, 0.f } ) )
+	, mUniform( std::exchange( aOther.mUniform, false ) )
+	, mUniformColor( aOther.mUniformColor )
 {}
 TriangleFan& TriangleFan::operator= (TriangleFan&& aOther)  noexcept
 {
 	std::swap( mCount, aOther.mCount );
 	std::swap( mVertices, aOther.mVertices );
 	std::swap( mColors, aOther.mColors );
+	std::swap( mIndices, aOther.mIndices );
+	std::swap( mRadius, aOther.mRadius );
+	std::swap( mBoundsMin, aOther.mBoundsMin );
+	std::swap( mBoundsMax, aOther.mBoundsMax );
+	std::swap( mUniform, aOther.mUniform );
+	std::swap( mUniformColor, aOther.mUniformColor );
 	return *this;
 }
 
+void TriangleFan::compute_bounds_() noexcept
+{
+	mRadius = 0.f;
+	mBoundsMin = mBoundsMax = mCount ? mVertices[0] : Vec2f{ 0.f, 0.f };
+
+	for( std::size_t i = 0; i < mCount; ++i )
+	{
+		Vec2f const v = mVertices[i];
+		mRadius = std::max( mRadius, length( v ) );
+		mBoundsMin = Vec2f{ std::min( mBoundsMin.x, v.x ), std::min( mBoundsMin.y, v.y ) };
+		mBoundsMax = Vec2f{ std::max( mBoundsMax.x, v.x ), std::max( mBoundsMax.y, v.y ) };
+	}
+}
+
+void TriangleFan::compute_uniform_() noexcept
+{
+	mUniform = false;
+	if( !mCount )
+		return;
+
+	ColorU8_sRGB first;
+	if( !uniform_color( mColors[0], mColors[0], mColors[0], first ) )
+		return;
+
+	for( std::size_t i = 1; i < mCount; ++i )
+	{
+		ColorU8_sRGB color;
+		if( !uniform_color( mColors[0], mColors[i], mColors[i], color ) )
+			return;
+	}
+
+	mUniform = true;
+	mUniformColor = first;
+}
+
+void TriangleFan::compute_indices_()
+{
+	if( mCount < 2 )
+		return;
+
+	// Triangle i-1 is (0, i-1, i); the last one wraps around to vertex 1.
+	mIndices = new std::uint32_t[3*(mCount-1)];
+
+	std::uint32_t* out = mIndices;
+	for( std::size_t i = 2; i <= mCount; ++i )
+	{
+		*out++ = 0;
+		*out++ = std::uint32_t(i-1);
+		*out++ = std::uint32_t(i < mCount ? i : 1);
+	}
+}
 
 void TriangleFan::draw( Surface& aSurface, Mat22f const& aRotation, Vec2f const& aTranslation ) const
 {
+	draw( aSurface, aRotation, aTranslation, EFanMode::triangles );
+}
+void TriangleFan::draw( Surface& aSurface, Mat22f const& aRotation, Vec2f const& aTranslation, EFanMode aMode ) const
+{
+	PixelRect const all{ 0, 0, int(aSurface.get_width()), int(aSurface.get_height()) };
+	draw_clipped_( aSurface, all, aRotation, aTranslation, aMode );
+}
+bool TriangleFan::draw( Surface& aSurface, Mat22f const& aRotation, Vec2f const& aTranslation, PixelRect const& aScissor, EFanMode aMode ) const
+{
+	PixelRect const clip{
+		std::max( aScissor.x0, 0 ),
+		std::max( aScissor.y0, 0 ),
+		std::min( aScissor.x1, int(aSurface.get_width()) ),
+		std::min( aScissor.y1, int(aSurface.get_height()) )
+	};
+
+	if( cull_( clip, aRotation, aTranslation ) )
+		return false;
+
+	draw_clipped_( aSurface, clip, aRotation, aTranslation, aMode );
+	return true;
+}
+void TriangleFan::draw_clipped_( Surface& aSurface, PixelRect const& aClip, Mat22f const& aRotation, Vec2f const& aTranslation, EFanMode aMode ) const
+{
+	if( mCount < 2 )
+		return;
+
+	if( EFanMode::scan == aMode )
+	{
+		if( mUniform )
+			rasterize_triangle_fan_solid( aSurface, aClip, mCount, mVertices, aRotation, aTranslation, mUniformColor );
+		else
+			rasterize_triangle_fan_interp( aSurface, aClip, mCount, mVertices, mColors, aRotation, aTranslation );
+		return;
+	}
+
+	// Submit the fan as a single indexed batch, such that each vertex is
+	// transformed only once (most of them are shared by two triangles, the
+	// center by all of them).
+	// The indices are set up at construction time.
+	std::size_t const triangles = mCount-1;
+
+	if( mUniform )
+		rasterize_triangles_solid( aSurface, aClip, mCount, mVertices, triangles, mIndices, aRotation, aTranslation, mUniformColor );
+	else
+		rasterize_triangles_interp( aSurface, aClip, mCount, mVertices, mColors, triangles, mIndices, aRotation, aTranslation );
+}
+void TriangleFan::draw( TriangleBinner& aBinner, Mat22f const& aRotation, Vec2f const& aTranslation ) const
+{
+	if( mCount < 2 )
+		return;
+
 	Vec2f const center = aRotation * mVertices[0] + aTranslation;
 	ColorF const cencol = mColors[0];
 
+	auto const submit = [&] (Vec2f aP1, Vec2f aP2, ColorF const& aC1, ColorF const& aC2) {
+		if( mUniform )
+			aBinner.draw_triangle_solid( center, aP1, aP2, mUniformColor );
+		else
+			aBinner.draw_triangle_interp( center, aP1, aP2, cencol, aC1, aC2 );
+	};
+
 	Vec2f previous = aRotation * mVertices[1] + aTranslation;
 	ColorF pcol = mColors[1];
 	for( std::size_t i = 2; i < mCount; ++i )
 	{
 		Vec2f const current = aRotation * mVertices[i] + aTranslation;
 		ColorF const curcol = mColors[i];
-		draw_triangle_interp( aSurface, center, previous, current, cencol, pcol, curcol );
+		submit( previous, current, pcol, curcol );
 		previous = current;
 		pcol = curcol;
 	}
 
 	Vec2f const first = aRotation * mVertices[1] + aTranslation;
 	ColorF const fcol = mColors[1];
-	draw_triangle_interp( aSurface, center, previous, first, cencol, pcol, fcol );
+	submit( previous, first, pcol, fcol );
+}
+
+bool TriangleFan::draw( TriangleBinner& aBinner, Mat22f const& aRotation, Vec2f const& aTranslation, PixelRect const& aScissor ) const
+{
+	if( cull_( aScissor, aRotation, aTranslation ) )
+		return false;
+
+	draw( aBinner, aRotation, aTranslation );
+	return true;
+}
+
+bool TriangleFan::cull_( PixelRect const& aClip, Mat22f const& aRotation, Vec2f const& aTranslation ) const noexcept
+{
+	// Transformed bounds, from both the bounding circle and the bounding
+	// box; each axis uses the tighter of the two. The Frobenius norm bounds
+	// how much aRotation can stretch the radius. The bounds are widened by
+	// a pixel (plus a relative term for float rounding in the vertex
+	// transform), so that rejected fans certainly cover no pixel centers.
+	float const norm = std::sqrt( aRotation._00*aRotation._00 + aRotation._01*aRotation._01 + aRotation._10*aRotation._10 + aRotation._11*aRotation._11 );
+	float const radius = mRadius * norm;
+
+	Vec2f const center = aRotation * (0.5f * (mBoundsMin + mBoundsMax)) + aTranslation;
+	Vec2f const half = 0.5f * (mBoundsMax - mBoundsMin);
+	Vec2f const extent{
+		std::abs( aRotation._00 ) * half.x + std::abs( aRotation._01 ) * half.y,
+		std::abs( aRotation._10 ) * half.x + std::abs( aRotation._11 ) * half.y
+	};
+
+	float const margin = 1.f + 1e-5f * (std::abs( aTranslation.x ) + std::abs( aTranslation.y ) + radius);
+
+	float const minX = std::max( center.x - extent.x, aTranslation.x - radius ) - margin;
+	float const maxX = std::min( center.x + extent.x, aTranslation.x + radius ) + margin;
+	float const minY = std::max( center.y - extent.y, aTranslation.y - radius ) - margin;
+	float const maxY = std::min( center.y + extent.y, aTranslation.y + radius ) + margin;
+
+	// Pixel centers are at +0.5. (Comparisons with NaNs are false, so such
+	// fans are passed on to the rasterizer, which rejects them.)
+	bool const outside = aClip.x0 >= aClip.x1 || aClip.y0 >= aClip.y1
+		|| maxX < float(aClip.x0) + 0.5f || minX > float(aClip.x1) - 0.5f
+		|| maxY < float(aClip.y0) + 0.5f || minY > float(aClip.y1) - 0.5f
+	;
+
+	auto& stats = gFanStats;
+	if( outside )
+	{
+		++stats.culled;
+		return true;
+	}
+
+	++stats.drawn;
+	return false;
+}
+
+FanStats fan_stats() noexcept
+{
+	return gFanStats;
+}
+void reset_fan_stats() noexcept
+{
+	gFanStats = FanStats{};
 }
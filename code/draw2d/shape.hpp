@@ -6,10 +6,13 @@
 // For CW1, the shape.hpp file must remain exactly as it is. In particular, you
 // must not change the LineStrip or TriangleFan class interfaces.
 
+#include <cstdint>
 #include <cstdlib>
 
+#include "draw.hpp"
 #include "forward.hpp"
 #include "color.hpp"
+#include "stroke.hpp"
 
 #include "../vmlib/vec2.hpp"
 #include "../vmlib/mat22.hpp"
@@ -56,10 +59,18 @@ class LineStrip final
 		 *
 		 * finalVertex = vertexIn * matrix + vector
 		 *
-		 * LineStrip::draw() uses draw_line_solid() internally.
+		 * LineStrip::draw() transforms each vertex once and draws all
+		 * segments with a single draw_lines_solid() call.
 		 */
 		void draw( Surface&, ColorF const&, Mat22f const&, Vec2f const& ) const;
 
+		/* Draw the line strip as a thick stroke, see stroke.hpp. Vertices
+		 * are transformed as for draw(); the stroke width is in pixels (it
+		 * is not transformed). The stroke is converted to triangles, which
+		 * are drawn in a single draw_triangles_solid() call.
+		 */
+		void draw_stroke( Surface&, ColorF const&, StrokeStyle const&, Mat22f const&, Vec2f const& ) const;
+
 		std::size_t vertex_count() const noexcept { return mCount; }
 
 	private:
@@ -67,6 +78,17 @@ class LineStrip final
 		Vec2f* mVertices;
 };
 
+/** Ways to rasterize a TriangleFan, see TriangleFan::draw(). Both produce
+ * exactly the same pixels. The scan sets up and evaluates fewer edges, but
+ * both shade the same spans, which usually dominates (see the asteroid
+ * benchmarks in triangles-benchmark).
+ */
+enum class EFanMode
+{
+	triangles, // indexed triangle batch, see draw_triangles_interp()
+	scan       // single pass over the fan's rows, see draw_triangle_fan_interp()
+};
+
 /** Triangle fan
  *
  * A triangle fan is a set of triangles, defined by a central vertex, and with
@@ -119,16 +141,89 @@ class TriangleFan final
 		 *
 		 * finalVertex = vertexIn * matrix + vector
 		 *
-		 * TriangleFan::draw() uses draw_triangle_interp() internally.  It uses
+		 * TriangleFan::draw() uses draw_triangles_interp() internally.  It uses
 		 * the (linear) per-vertex colors assigned at construction time.
 		 */
 		void draw( Surface&, Mat22f const&, Vec2f const& ) const;
 
+		/* Same as above, but with the given rasterization mode, see EFanMode.
+		 */
+		void draw( Surface&, Mat22f const&, Vec2f const&, EFanMode ) const;
+
+		/* Same as above, but only pixels within aScissor (and the surface)
+		 * are drawn. Before any vertex is transformed, the whole fan is
+		 * rejected if its transformed bounds (see bounding_radius() and
+		 * bounds_min()/bounds_max()) miss aScissor. Returns false if the fan
+		 * was rejected. Counted in fan_stats().
+		 */
+		bool draw( Surface&, Mat22f const&, Vec2f const&, PixelRect const& aScissor, EFanMode = EFanMode::triangles ) const;
+
+		/* Same as above, but submits the triangles to a TriangleBinner (see
+		 * binner.hpp). They are drawn by TriangleBinner::flush().
+		 */
+		void draw( TriangleBinner&, Mat22f const&, Vec2f const& ) const;
+
+		/* Same as above, but the fan is first culled against aScissor like
+		 * in the culling draw() overload (and counted in fan_stats()). The
+		 * binner has no scissor: the triangles of fans that are not
+		 * rejected are submitted in full. Returns false if the fan was
+		 * rejected.
+		 */
+		bool draw( TriangleBinner&, Mat22f const&, Vec2f const&, PixelRect const& aScissor ) const;
+
+		/* Bounds of the untransformed vertices, computed at construction
+		 * time: the largest distance of a vertex from the origin (the center
+		 * of rotation), and the axis-aligned bounding box.
+		 */
+		float bounding_radius() const noexcept { return mRadius; }
+
+		Vec2f bounds_min() const noexcept { return mBoundsMin; }
+		Vec2f bounds_max() const noexcept { return mBoundsMax; }
+
+		/* True if all vertex colors convert to the same sRGB color, checked
+		 * at construction time. Such fans are filled with that color rather
+		 * than interpolated, which skips the per-triangle checks and color
+		 * planes.
+		 */
+		bool has_uniform_color() const noexcept { return mUniform; }
+
+	private:
+		void compute_bounds_() noexcept;
+		void compute_uniform_() noexcept;
+		void compute_indices_();
+		// True if the transformed bounds miss aClip; counted in fan_stats()
+		bool cull_( PixelRect const& aClip, Mat22f const&, Vec2f const& ) const noexcept;
+		void draw_clipped_( Surface&, PixelRect const&, Mat22f const&, Vec2f const&, EFanMode ) const;
 
 	private:
 		std::size_t mCount;
 		Vec2f* mVertices;
 		ColorF* mColors;
+
+		// Indices of the fan's triangles, for the indexed batches
+		// (3*(mCount-1) of them; null if there are no triangles)
+		std::uint32_t* mIndices;
+
+		float mRadius;
+		Vec2f mBoundsMin, mBoundsMax;
+
+		bool mUniform;
+		ColorU8_sRGB mUniformColor;
 };
 
+/** Fan culling statistics
+ *
+ * Counts the fans passed to the culling TriangleFan::draw() overloads (see
+ * above), by whether they were drawn or rejected. The counters are kept per
+ * thread.
+ */
+struct FanStats
+{
+	std::uint64_t drawn;
+	std::uint64_t culled;
+};
+
+FanStats fan_stats() noexcept;
+void reset_fan_stats() noexcept;
+
 #endif // SHAPE_HPP_4AC47446_8CA0_4AFF_AD91_D6B54EFEF21A
@@ -0,0 +1,170 @@
+#include "stroke.hpp"
+
+#include <algorithm>
+
+#include <cmath>
+#include <cassert>
+
+namespace
+{
+	constexpr float kPi = 3.14159265358979f;
+
+	// Round joins are approximated by a fan of triangles. The number of
+	// triangles is chosen such that the arc deviates by at most this many
+	// pixels from the true circle.
+	constexpr float kRoundTolerance = 0.25f;
+
+	Vec2f perp_( Vec2f ) noexcept;
+	float cross_( Vec2f, Vec2f ) noexcept;
+
+	void push_triangle_( std::vector<Vec2f>&, Vec2f, Vec2f, Vec2f );
+	void add_join_( std::vector<Vec2f>&, Vec2f aPoint, Vec2f aDirIn, Vec2f aDirOut, float aHalfWidth, StrokeStyle const& );
+}
+
+void stroke_polyline( std::vector<Vec2f>& aTriangles, std::size_t aCount, Vec2f const* aPoints, StrokeStyle const& aStyle )
+{
+	assert( aPoints || 0 == aCount );
+
+	float const halfWidth = 0.5f * aStyle.width;
+	if( !(halfWidth > 0.f) )
+		return;
+
+	// Collect the segments between distinct points, with their (unit)
+	// directions.
+	struct Segment_
+	{
+		Vec2f begin, end, dir;
+	};
+
+	std::vector<Segment_> segments;
+	segments.reserve( aCount );
+
+	for( std::size_t i = 1; i < aCount; ++i )
+	{
+		Vec2f const begin = segments.empty() ? aPoints[i-1] : segments.back().end;
+		Vec2f const delta = aPoints[i] - begin;
+
+		float const len = length( delta );
+		if( !(len > 0.f) || !std::isfinite( len ) )
+			continue;
+
+		segments.emplace_back( Segment_{ begin, aPoints[i], delta / len } );
+	}
+
+	if( segments.empty() )
+		return;
+
+	if( ELineCap::square == aStyle.cap )
+	{
+		segments.front().begin -= halfWidth * segments.front().dir;
+		segments.back().end += halfWidth * segments.back().dir;
+	}
+
+	aTriangles.reserve( aTriangles.size() + 6*segments.size() );
+
+	for( std::size_t i = 0; i < segments.size(); ++i )
+	{
+		auto const& seg = segments[i];
+		Vec2f const normal = halfWidth * perp_( seg.dir );
+
+		Vec2f const a = seg.begin + normal;
+		Vec2f const b = seg.begin - normal;
+		Vec2f const c = seg.end - normal;
+		Vec2f const d = seg.end + normal;
+
+		push_triangle_( aTriangles, a, b, c );
+		push_triangle_( aTriangles, a, c, d );
+
+		if( i+1 < segments.size() )
+			add_join_( aTriangles, seg.end, seg.dir, segments[i+1].dir, halfWidth, aStyle );
+	}
+}
+
+namespace
+{
+	Vec2f perp_( Vec2f aVec ) noexcept
+	{
+		return { -aVec.y, aVec.x };
+	}
+	float cross_( Vec2f aLeft, Vec2f aRight ) noexcept
+	{
+		return aLeft.x * aRight.y - aLeft.y * aRight.x;
+	}
+
+	void push_triangle_( std::vector<Vec2f>& aTriangles, Vec2f aP0, Vec2f aP1, Vec2f aP2 )
+	{
+		aTriangles.emplace_back( aP0 );
+		aTriangles.emplace_back( aP1 );
+		aTriangles.emplace_back( aP2 );
+	}
+
+	void add_join_( std::vector<Vec2f>& aTriangles, Vec2f aPoint, Vec2f aDirIn, Vec2f aDirOut, float aHalfWidth, StrokeStyle const& aStyle )
+	{
+		// The segment quads already meet along the inner side of the corner.
+		// The join fills the wedge on the outer side. Straight continuations
+		// need no join.
+		float const turn = cross_( aDirIn, aDirOut );
+		if( std::abs( turn ) < 1e-6f && dot( aDirIn, aDirOut ) > 0.f )
+			return;
+
+		float const side = turn > 0.f ? -1.f : 1.f;
+		Vec2f const u0 = side * perp_( aDirIn );
+		Vec2f const u1 = side * perp_( aDirOut );
+
+		Vec2f const p0 = aPoint + aHalfWidth * u0;
+		Vec2f const p1 = aPoint + aHalfWidth * u1;
+
+		switch( aStyle.join )
+		{
+			case ELineJoin::miter:
+			{
+				// |u0+u1| = 2 cos(a/2), where a is the angle between the
+				// normals. The miter tip is at distance w/(2 cos(a/2)) from
+				// the point, so the miter ratio is 2/|u0+u1|.
+				Vec2f const mid = u0 + u1;
+				float const midLen2 = dot( mid, mid );
+				float const limit = std::max( aStyle.miterLimit, 1.f );
+
+				if( 4.f <= limit * limit * midLen2 )
+				{
+					Vec2f const tip = aPoint + (2.f * aHalfWidth / midLen2) * mid;
+					push_triangle_( aTriangles, aPoint, p0, tip );
+					push_triangle_( aTriangles, aPoint, tip, p1 );
+					return;
+				}
+			} [[fallthrough]];
+
+			case ELineJoin::bevel:
+			{
+				push_triangle_( aTriangles, aPoint, p0, p1 );
+			} break;
+
+			case ELineJoin::round:
+			{
+				float const a0 = std::atan2( u0.y, u0.x );
+				float sweep = std::atan2( u1.y, u1.x ) - a0;
+				if( sweep > kPi ) sweep -= 2.f*kPi;
+				if( sweep < -kPi ) sweep += 2.f*kPi;
+
+				float const maxStep = aHalfWidth > kRoundTolerance
+					? 2.f * std::acos( 1.f - kRoundTolerance / aHalfWidth )
+					: 0.5f * kPi
+				;
+				int const steps = std::max( 1, int(std::ceil( std::abs( sweep ) / maxStep )) );
+
+				Vec2f prev = p0;
+				for( int i = 1; i <= steps; ++i )
+				{
+					float const angle = a0 + sweep * float(i) / float(steps);
+					Vec2f const next = i == steps
+						? p1
+						: aPoint + aHalfWidth * Vec2f{ std::cos( angle ), std::sin( angle ) }
+					;
+
+					push_triangle_( aTriangles, aPoint, prev, next );
+					prev = next;
+				}
+			} break;
+		}
+	}
+}
@@ -0,0 +1,51 @@
+#ifndef STROKE_HPP_6F2B0C8E_3D4A_4E61_9B57_A1C3E8D0F472
+#define STROKE_HPP_6F2B0C8E_3D4A_4E61_9B57_A1C3E8D0F472
+
+// Stroking of thick polylines
+//
+// A stroke is converted to a list of triangles, which can then be rasterized
+// with draw_triangles_solid(). The triangles of a stroke overlap (e.g., at the
+// joins), but draw_triangles_solid() still writes each covered pixel exactly
+// once.
+
+#include <vector>
+
+#include <cstddef>
+
+#include "../vmlib/vec2.hpp"
+
+enum class ELineJoin
+{
+	miter, // falls back to bevel if the miter limit is exceeded
+	bevel,
+	round
+};
+
+enum class ELineCap
+{
+	butt,  // stroke ends exactly at the end points
+	square // stroke extends by half its width past the end points
+};
+
+struct StrokeStyle
+{
+	float width = 1.f;
+	ELineJoin join = ELineJoin::miter;
+	ELineCap cap = ELineCap::butt;
+
+	// Maximal ratio of the miter length to the stroke width. Same meaning as
+	// in SVG (stroke-miterlimit). Sharper corners are beveled.
+	float miterLimit = 4.f;
+};
+
+// Append the triangles for the stroke of the polyline aPoints[0..aCount) to
+// aTriangles (three vertices per triangle). Consecutive duplicate points are
+// ignored. Nothing is added for fewer than two distinct points or for a
+// non-positive width.
+void stroke_polyline(
+	std::vector<Vec2f>& aTriangles,
+	std::size_t aCount, Vec2f const* aPoints,
+	StrokeStyle const&
+);
+
+#endif // STROKE_HPP_6F2B0C8E_3D4A_4E61_9B57_A1C3E8D0F472
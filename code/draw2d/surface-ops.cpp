@@ -0,0 +1,86 @@
+#include "surface-ops.hpp"
+
+#include <atomic>
+#include <algorithm>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "surface.hpp"
+#include "block-kernels.hpp"
+
+namespace
+{
+	std::atomic<EStoreMode> gStoreMode{ EStoreMode::automatic };
+}
+
+void fill_rect( Surface& aSurface, PixelRect const& aRect, ColorU8_sRGB aColor ) noexcept
+{
+	int const x0 = std::max( aRect.x0, 0 );
+	int const y0 = std::max( aRect.y0, 0 );
+	int const x1 = std::min( aRect.x1, int(aSurface.get_width()) );
+	int const y1 = std::min( aRect.y1, int(aSurface.get_height()) );
+	if( x0 >= x1 || y0 >= y1 )
+		return;
+
+	aSurface.mark_dirty( PixelRect{ x0, y0, x1, y1 } );
+	fill_rows( aSurface.get_row_ptr( Surface::Index(y0) ) + x0, std::ptrdiff_t(aSurface.get_pitch() / sizeof(PixelRGBx32)), x1-x0, y1-y0, pack_rgbx( aColor ) );
+}
+
+void copy_rect( Surface& aDst, int aDstX, int aDstY, Surface const& aSrc, PixelRect const& aSrcRect ) noexcept
+{
+	// Clip the source rectangle to the source surface, and then to the
+	// destination surface (in source coordinates). 64-bit intermediates, so
+	// that extreme offsets cannot overflow.
+	std::int64_t const dx = std::int64_t(aDstX) - aSrcRect.x0;
+	std::int64_t const dy = std::int64_t(aDstY) - aSrcRect.y0;
+
+	std::int64_t const x0 = std::max<std::int64_t>( { aSrcRect.x0, 0, -dx } );
+	std::int64_t const y0 = std::max<std::int64_t>( { aSrcRect.y0, 0, -dy } );
+	std::int64_t const x1 = std::min<std::int64_t>( { aSrcRect.x1, aSrc.get_width(), std::int64_t(aDst.get_width()) - dx } );
+	std::int64_t const y1 = std::min<std::int64_t>( { aSrcRect.y1, aSrc.get_height(), std::int64_t(aDst.get_height()) - dy } );
+	if( x0 >= x1 || y0 >= y1 )
+		return;
+
+	int const width = int(x1 - x0);
+	int const height = int(y1 - y0);
+
+	aDst.mark_dirty( PixelRect{ int(x0 + dx), int(y0 + dy), int(x0 + dx) + width, int(y0 + dy) + height } );
+
+	std::uint32_t* const dst = aDst.get_row_ptr( Surface::Index(y0 + dy) ) + (x0 + dx);
+	std::uint32_t const* const src = aSrc.get_row_ptr( Surface::Index(y0) ) + x0;
+
+	std::ptrdiff_t const dstPitch = std::ptrdiff_t(aDst.get_pitch() / sizeof(PixelRGBx32));
+	std::ptrdiff_t const srcPitch = std::ptrdiff_t(aSrc.get_pitch() / sizeof(PixelRGBx32));
+
+	// Within a single surface, the rectangles may overlap. Rows are then
+	// copied in an order that reads each row before it is overwritten, and
+	// each row is copied with std::memmove().
+	if( &aDst == &aSrc && std::abs( dx ) < width && std::abs( dy ) < height )
+	{
+		auto const bytes = sizeof(std::uint32_t) * std::size_t(width);
+		if( dy > 0 )
+		{
+			for( int y = height; y-- > 0; )
+				std::memmove( dst + y*dstPitch, src + y*srcPitch, bytes );
+		}
+		else
+		{
+			for( int y = 0; y < height; ++y )
+				std::memmove( dst + y*dstPitch, src + y*srcPitch, bytes );
+		}
+		return;
+	}
+
+	copy_rows( dst, dstPitch, src, srcPitch, width, height );
+}
+
+EStoreMode store_mode() noexcept
+{
+	return gStoreMode.load( std::memory_order_relaxed );
+}
+void set_store_mode( EStoreMode aMode ) noexcept
+{
+	gStoreMode.store( aMode, std::memory_order_relaxed );
+}
+
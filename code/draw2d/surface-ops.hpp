@@ -0,0 +1,43 @@
+#ifndef SURFACE_OPS_HPP_3A7C1E94_B25D_4F08_9E61_D84B20C7F5A3
+#define SURFACE_OPS_HPP_3A7C1E94_B25D_4F08_9E61_D84B20C7F5A3
+
+// Bulk operations on surfaces
+//
+// Fills and copies of rectangular blocks of pixels. These write whole rows of
+// packed 32-bit pixels, with the widest stores that the CPU supports (see
+// cpu.hpp). Large blocks use non-temporal (streaming) stores, which bypass the
+// caches; see EStoreMode. Surface::clear() and Surface::fill() use the same
+// code.
+
+#include "draw.hpp"
+#include "color.hpp"
+#include "forward.hpp"
+
+// Fill a rectangle of pixels with the specified color. The rectangle is
+// clipped to the surface.
+void fill_rect( Surface&, PixelRect const&, ColorU8_sRGB ) noexcept;
+
+// Copy the pixels aSrcRect of aSrc to aDst, such that the rectangle's top
+// left corner ends up at (aDstX,aDstY). The rectangle is clipped to both
+// surfaces. aSrc and aDst may be the same surface, even if the source and
+// destination rectangles overlap.
+void copy_rect( Surface& aDst, int aDstX, int aDstY, Surface const& aSrc, PixelRect const& aSrcRect ) noexcept;
+
+// Streaming stores
+//
+// By default (automatic), blocks larger than a typical L2 cache are written
+// with streaming stores and smaller ones with regular stores. This can be
+// overridden, mainly for tests and benchmarks that compare the variants. Like
+// set_simd_level_limit(), the mode is global; it should not be changed while
+// drawing is in progress.
+enum class EStoreMode
+{
+	automatic,
+	regular,
+	streaming
+};
+
+EStoreMode store_mode() noexcept;
+void set_store_mode( EStoreMode ) noexcept;
+
+#endif // SURFACE_OPS_HPP_3A7C1E94_B25D_4F08_9E61_D84B20C7F5A3
@@ -1,57 +1,391 @@
 #include "surface.hpp"
 #include "color.hpp"
+#include "surface-ops.hpp"
 
+#include <new>
+#include <atomic>
+#include <memory>
 #include <utility>
+#include <algorithm>
 
-#include <cstring>  // This defines std::memset()...
+#include <cstring>
+
+#if defined(__linux__)
+#	include <sys/mman.h>
+#endif
+
+namespace
+{
+	// Statistics are collected per thread, see surface_alloc_stats().
+	thread_local SurfaceAllocStats gSurfaceAllocStats{};
+
+	std::atomic<bool> gHugePages{ false };
+
+	// Huge page size assumed for rounding. This is the default size on
+	// x86_64 (and on most ARM64 configurations).
+	constexpr std::size_t kHugePageSize = std::size_t(2) << 20;
+
+	Surface::Index pitch_( Surface::Index aWidth ) noexcept;
+
+	// allocate_() may round aBytes up (huge pages are allocated in whole
+	// pages), and returns the backing it used in aStorage.
+	std::uint8_t* allocate_( std::size_t& aBytes, ESurfaceStorage& aStorage );
+	void deallocate_( std::uint8_t*, std::size_t, ESurfaceStorage ) noexcept;
+
+	// Calls aFn( x0, y0, x1, y1 ) for rectangles of tiles that cover all
+	// tiles with a state that has any of the bits in aMask. Horizontal runs
+	// of such tiles are merged, and a run is extended downwards as long as
+	// the rows below have exactly the same run.
+	template< typename tFn >
+	void for_each_tile_rect_( std::atomic<std::uint8_t> const*, Surface::Index aTilesX, Surface::Index aTilesY, std::uint8_t aMask, tFn&& aFn );
+}
 
 Surface::Surface( Index aWidth, Index aHeight )
 	: mSurface( nullptr )
-	, mWidth( aWidth )
-	, mHeight( aHeight )
+	, mWidth( 0 )
+	, mHeight( 0 )
+	, mPitch( 0 )
+	, mCapacity( 0 )
+	, mStorage( ESurfaceStorage::heap )
+	, mTilesX( 0 )
+	, mTilesY( 0 )
+	, mTileCapacity( 0 )
+	, mClearedBytes( 0 )
 {
-	mSurface = new std::uint8_t[ mWidth * mHeight * 4 ];
+	resize( aWidth, aHeight );
 }
 Surface::~Surface()
 {
-	delete [] mSurface;
+	deallocate_( mSurface, mCapacity, mStorage );
 }
 
 Surface::Surface( Surface&& aOther ) noexcept
 	: mSurface( std::exchange( aOther.mSurface, nullptr ) )
 	, mWidth( std::exchange( aOther.mWidth, 0 ) )
 	, mHeight( std::exchange( aOther.mHeight, 0 ) )
+	, mPitch( std::exchange( aOther.mPitch, 0 ) )
+	, mCapacity( std::exchange( aOther.mCapacity, 0 ) )
+	, mStorage( std::exchange( aOther.mStorage, ESurfaceStorage::heap ) )
+	, mTiles( std::move( aOther.mTiles ) )
+	, mTilesX( std::exchange( aOther.mTilesX, 0 ) )
+	, mTilesY( std::exchange( aOther.mTilesY, 0 ) )
+	, mTileCapacity( std::exchange( aOther.mTileCapacity, 0 ) )
+	, mClearedBytes( std::exchange( aOther.mClearedBytes, 0 ) )
 {}
 Surface& Surface::operator=( Surface&& aOther ) noexcept
 {
 	std::swap( mSurface, aOther.mSurface );
 	std::swap( mWidth, aOther.mWidth );
 	std::swap( mHeight, aOther.mHeight );
+	std::swap( mPitch, aOther.mPitch );
+	std::swap( mCapacity, aOther.mCapacity );
+	std::swap( mStorage, aOther.mStorage );
+	std::swap( mTiles, aOther.mTiles );
+	std::swap( mTilesX, aOther.mTilesX );
+	std::swap( mTilesY, aOther.mTilesY );
+	std::swap( mTileCapacity, aOther.mTileCapacity );
+	std::swap( mClearedBytes, aOther.mClearedBytes );
 	return *this;
 }
 
 
+void Surface::resize( Index aWidth, Index aHeight )
+{
+	auto const pitch = pitch_( aWidth );
+	auto const bytes = std::size_t(pitch) * aHeight;
+
+	auto const tilesX = (aWidth + kDirtyTileSize-1) >> kDirtyTileShift;
+	auto const tilesY = (aHeight + kDirtyTileSize-1) >> kDirtyTileShift;
+	auto const tiles = std::size_t(tilesX) * tilesY;
+
+	// Grow by at least half of the current capacity. An interactive resize
+	// grows the window by a few pixels per event; it should not reallocate
+	// every time.
+	if( !mSurface || bytes > mCapacity )
+	{
+		auto capacity = std::max( bytes, mCapacity + mCapacity/2 );
+		auto backing = ESurfaceStorage::heap;
+		auto* const storage = allocate_( capacity, backing );
+
+		deallocate_( mSurface, mCapacity, mStorage );
+		mSurface = storage;
+		mCapacity = capacity;
+		mStorage = backing;
+	}
+	else
+	{
+		++gSurfaceAllocStats.reuses;
+	}
+
+	if( !mTiles || tiles > mTileCapacity )
+	{
+		auto const capacity = std::max( tiles, mTileCapacity + mTileCapacity/2 );
+		mTiles = std::make_unique<std::atomic<std::uint8_t>[]>( capacity );
+		mTileCapacity = capacity;
+	}
+
+	mWidth = aWidth;
+	mHeight = aHeight;
+	mPitch = pitch;
+	mTilesX = tilesX;
+	mTilesY = tilesY;
+	mClearedBytes = 0;
+
+	// Zero everything, including the padding at the end of each row. The
+	// padding is never written afterwards.
+	std::memset( mSurface, 0, bytes );
+
+	// The surface is black (nothing to clear), but it has not been presented
+	// yet.
+	for( std::size_t i = 0; i < tiles; ++i )
+		mTiles[i].store( kTileDirty, std::memory_order_relaxed );
+}
+
 void Surface::clear() noexcept
 {
-	std::memset( mSurface, 0, sizeof(std::uint8_t)*mWidth*mHeight*4 );
+	// Tiles that weren't drawn are still black. The drawn ones are cleared
+	// in as few (and as large) blocks as possible; see surface-ops.hpp. For
+	// large blocks, fill_rect() uses streaming stores, which is faster than
+	// std::memset() with regular stores.
+	mClearedBytes = 0;
+	for_each_tile_rect_( mTiles.get(), mTilesX, mTilesY, kTileDrawn, [&] (Index aX0, Index aY0, Index aX1, Index aY1) {
+		PixelRect const rect{
+			int(aX0 << kDirtyTileShift), int(aY0 << kDirtyTileShift),
+			int(std::min( aX1 << kDirtyTileShift, mWidth )), int(std::min( aY1 << kDirtyTileShift, mHeight ))
+		};
+
+		fill_rect( *this, rect, { 0, 0, 0 } );
+		mClearedBytes += std::size_t(rect.x1-rect.x0) * std::size_t(rect.y1-rect.y0) * 4;
+	} );
+
+	// The cleared tiles are black again, but they still need to be
+	// presented.
+	auto const tiles = std::size_t(mTilesX) * mTilesY;
+	for( std::size_t i = 0; i < tiles; ++i )
+	{
+		if( mTiles[i].load( std::memory_order_relaxed ) & kTileDrawn )
+			mTiles[i].store( kTileDirty, std::memory_order_relaxed );
+	}
 }
 
 void Surface::fill( ColorU8_sRGB aColor ) noexcept
 {
-	// This can be optimized quite a bit. 8 bit loads and stores are generally
-	// not the most efficient.
-	auto const limit = mWidth * mHeight * 4;
-	for( std::size_t i = 0; i < limit; i += 4 )
+	// Packed 32-bit pixels, whole rows at a time (see surface-ops.hpp).
+	// fill_rect() marks the whole surface as drawn; a black surface has
+	// nothing left to clear, though.
+	fill_rect( *this, PixelRect{ 0, 0, int(mWidth), int(mHeight) }, aColor );
+
+	if( 0 == aColor.r && 0 == aColor.g && 0 == aColor.b )
 	{
-		mSurface[i+0] = aColor.r;
-		mSurface[i+1] = aColor.g;
-		mSurface[i+2] = aColor.b;
-		mSurface[i+3] = 0;
+		auto const tiles = std::size_t(mTilesX) * mTilesY;
+		for( std::size_t i = 0; i < tiles; ++i )
+			mTiles[i].store( kTileDirty, std::memory_order_relaxed );
 	}
 }
 
+std::uint8_t* Surface::get_surface_ptr() noexcept
+{
+	return mSurface;
+}
 std::uint8_t const* Surface::get_surface_ptr() const noexcept
 {
 	return mSurface;
 }
 
+void Surface::mark_dirty( PixelRect const& aRect ) noexcept
+{
+	int const x0 = std::max( aRect.x0, 0 );
+	int const y0 = std::max( aRect.y0, 0 );
+	int const x1 = std::min( aRect.x1, int(mWidth) );
+	int const y1 = std::min( aRect.y1, int(mHeight) );
+	if( x0 >= x1 || y0 >= y1 )
+		return;
+
+	auto const tx0 = Index(x0) >> kDirtyTileShift, tx1 = Index(x1-1) >> kDirtyTileShift;
+	auto const ty0 = Index(y0) >> kDirtyTileShift, ty1 = Index(y1-1) >> kDirtyTileShift;
+
+	for( Index ty = ty0; ty <= ty1; ++ty )
+	{
+		auto* const row = mTiles.get() + std::size_t(ty) * mTilesX;
+		for( Index tx = tx0; tx <= tx1; ++tx )
+			row[tx].store( std::uint8_t(kTileDrawn | kTileDirty), std::memory_order_relaxed );
+	}
+}
+
+void Surface::get_dirty_rects( std::vector<PixelRect>& aRects ) const
+{
+	for_each_tile_rect_( mTiles.get(), mTilesX, mTilesY, kTileDirty, [&] (Index aX0, Index aY0, Index aX1, Index aY1) {
+		aRects.emplace_back( PixelRect{
+			int(aX0 << kDirtyTileShift), int(aY0 << kDirtyTileShift),
+			int(std::min( aX1 << kDirtyTileShift, mWidth )), int(std::min( aY1 << kDirtyTileShift, mHeight ))
+		} );
+	} );
+}
+
+void Surface::clear_dirty() noexcept
+{
+	auto const tiles = std::size_t(mTilesX) * mTilesY;
+	for( std::size_t i = 0; i < tiles; ++i )
+	{
+		auto const state = mTiles[i].load( std::memory_order_relaxed );
+		mTiles[i].store( std::uint8_t(state & ~kTileDirty), std::memory_order_relaxed );
+	}
+}
+
+SurfaceAllocStats surface_alloc_stats() noexcept
+{
+	return gSurfaceAllocStats;
+}
+void reset_surface_alloc_stats() noexcept
+{
+	gSurfaceAllocStats = SurfaceAllocStats{};
+}
+
+void set_surface_huge_pages( bool aEnable ) noexcept
+{
+	gHugePages.store( aEnable, std::memory_order_relaxed );
+}
+bool surface_huge_pages() noexcept
+{
+	return gHugePages.load( std::memory_order_relaxed );
+}
+
+char const* to_string( ESurfaceStorage aStorage ) noexcept
+{
+	switch( aStorage )
+	{
+		case ESurfaceStorage::heap: return "heap";
+		case ESurfaceStorage::hugeTLB: return "hugetlb";
+		case ESurfaceStorage::hugeAdvised: return "madvise";
+	}
+	return "?";
+}
+
+namespace
+{
+	Surface::Index pitch_( Surface::Index aWidth ) noexcept
+	{
+		constexpr auto kAlign = Surface::kSurfaceAlignment;
+		return (aWidth * 4 + kAlign-1) / kAlign * kAlign;
+	}
+
+	std::uint8_t* allocate_( std::size_t& aBytes, ESurfaceStorage& aStorage )
+	{
+#		if defined(__linux__)
+		if( aBytes >= kHugePageSize && gHugePages.load( std::memory_order_relaxed ) )
+		{
+			// Mappings are page aligned, which satisfies kSurfaceAlignment.
+			auto const bytes = (aBytes + kHugePageSize-1) / kHugePageSize * kHugePageSize;
+
+			// Explicitly reserved huge pages. Usually none are reserved
+			// (see /proc/sys/vm/nr_hugepages), in which case this fails.
+			void* ptr = ::mmap( nullptr, bytes, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0 );
+			if( MAP_FAILED != ptr )
+			{
+				aBytes = bytes;
+				aStorage = ESurfaceStorage::hugeTLB;
+				++gSurfaceAllocStats.allocations;
+				gSurfaceAllocStats.bytesAllocated += bytes;
+				return static_cast<std::uint8_t*>(ptr);
+			}
+
+#			if defined(MADV_HUGEPAGE)
+			// Transparent huge pages. The kernel may still decide to use
+			// regular pages (e.g., if THP is disabled).
+			ptr = ::mmap( nullptr, bytes, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0 );
+			if( MAP_FAILED != ptr )
+			{
+				if( 0 == ::madvise( ptr, bytes, MADV_HUGEPAGE ) )
+				{
+					aBytes = bytes;
+					aStorage = ESurfaceStorage::hugeAdvised;
+					++gSurfaceAllocStats.allocations;
+					gSurfaceAllocStats.bytesAllocated += bytes;
+					return static_cast<std::uint8_t*>(ptr);
+				}
+
+				::munmap( ptr, bytes );
+			}
+#			endif // ~ MADV_HUGEPAGE
+		}
+#		endif // ~ __linux__
+
+		auto* const ptr = static_cast<std::uint8_t*>(::operator new[]( aBytes, std::align_val_t( Surface::kSurfaceAlignment ) ));
+
+		aStorage = ESurfaceStorage::heap;
+		++gSurfaceAllocStats.allocations;
+		gSurfaceAllocStats.bytesAllocated += aBytes;
+		return ptr;
+	}
+	void deallocate_( std::uint8_t* aPtr, std::size_t aBytes, ESurfaceStorage aStorage ) noexcept
+	{
+		if( !aPtr )
+			return;
+
+		++gSurfaceAllocStats.deallocations;
+
+		if( ESurfaceStorage::heap == aStorage )
+		{
+			::operator delete[]( aPtr, std::align_val_t( Surface::kSurfaceAlignment ) );
+			return;
+		}
+
+#		if defined(__linux__)
+		::munmap( aPtr, aBytes );
+#		else
+		(void)aBytes;
+#		endif
+	}
+
+	template< typename tFn >
+	void for_each_tile_rect_( std::atomic<std::uint8_t> const* aTiles, Surface::Index aTilesX, Surface::Index aTilesY, std::uint8_t aMask, tFn&& aFn )
+	{
+		using Index = Surface::Index;
+
+		auto const set = [&] (Index aX, Index aY) {
+			return 0 != (aTiles[std::size_t(aY) * aTilesX + aX].load( std::memory_order_relaxed ) & aMask);
+		};
+
+		// Does row aY have a run of exactly the tiles [aX0,aX1)?
+		auto const same_run = [&] (Index aX0, Index aX1, Index aY) {
+			if( aX0 > 0 && set( aX0-1, aY ) )
+				return false;
+			if( aX1 < aTilesX && set( aX1, aY ) )
+				return false;
+			for( Index x = aX0; x < aX1; ++x )
+			{
+				if( !set( x, aY ) )
+					return false;
+			}
+			return true;
+		};
+
+		for( Index y = 0; y < aTilesY; ++y )
+		{
+			Index x = 0;
+			while( x < aTilesX )
+			{
+				if( !set( x, y ) )
+				{
+					++x;
+					continue;
+				}
+
+				Index const x0 = x;
+				while( x < aTilesX && set( x, y ) )
+					++x;
+
+				// Runs that continue a run of the row above were already
+				// covered by that run's rectangle.
+				if( y > 0 && same_run( x0, x, y-1 ) )
+					continue;
+
+				Index y1 = y+1;
+				while( y1 < aTilesY && same_run( x0, x, y1 ) )
+					++y1;
+
+				aFn( x0, y, x, y1 );
+			}
+		}
+	}
+}
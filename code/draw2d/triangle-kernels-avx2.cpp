@@ -0,0 +1,89 @@
+#include "triangle-kernels.hpp"
+
+#if DRAW2D_TRIANGLE_AVX2
+
+#include <cassert>
+#include <cstddef>
+
+#include <immintrin.h>
+
+namespace
+{
+	DRAW2D_TARGET_AVX2 __m256i to_srgb_( __m256, SrgbLuts const& ) noexcept;
+}
+
+DRAW2D_TARGET_AVX2
+void shade_span_interp_avx2( std::uint32_t* aRow, int aX0, int aX1, int aY, ColorPlane const aPlanes[3] ) noexcept
+{
+	assert( aX0 <= aX1 );
+
+	__m256 row[3], step[3];
+	for( int c = 0; c < 3; ++c )
+	{
+		row[c] = _mm256_set1_ps( row_value( aPlanes[c], aY ) );
+		step[c] = _mm256_set1_ps( aPlanes[c].dx );
+	}
+
+	auto const& luts = srgb_luts();
+
+	auto const lanes = _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 );
+	auto const half = _mm256_set1_ps( 0.5f );
+	auto* const out = aRow + aX0;
+
+	int const count = aX1 - aX0;
+	for( int i = 0; i < count; i += 8 )
+	{
+		auto const index = _mm256_add_epi32( _mm256_set1_epi32( i ), lanes );
+		auto const px = _mm256_add_ps( _mm256_cvtepi32_ps( _mm256_add_epi32( _mm256_set1_epi32( aX0 ), index ) ), half );
+
+		// Separate multiply and add (no FMA), like the scalar code
+		auto const r = to_srgb_( _mm256_add_ps( row[0], _mm256_mul_ps( step[0], px ) ), luts );
+		auto const g = to_srgb_( _mm256_add_ps( row[1], _mm256_mul_ps( step[1], px ) ), luts );
+		auto const b = to_srgb_( _mm256_add_ps( row[2], _mm256_mul_ps( step[2], px ) ), luts );
+
+		// RGBx, with red in the lowest byte (little endian)
+		auto const pixels = _mm256_or_si256( r, _mm256_or_si256( 
+			_mm256_slli_epi32( g, 8 ), 
+			_mm256_slli_epi32( b, 16 ) 
+		) );
+
+		auto const mask = _mm256_cmpgt_epi32( _mm256_set1_epi32( count ), index );
+		_mm256_maskstore_epi32( reinterpret_cast<int*>(out + i), mask, pixels );
+	}
+}
+
+namespace
+{
+	DRAW2D_TARGET_AVX2
+	__m256i to_srgb_( __m256 aValue, SrgbLuts const& aLuts ) noexcept
+	{
+		// Same steps as linear_to_srgb() in the LUT mode. Clamp to [0,1];
+		// _mm256_max_ps() returns the second operand for NaN.
+		auto const value = _mm256_min_ps( 
+			_mm256_max_ps( aValue, _mm256_setzero_ps() ), 
+			_mm256_set1_ps( 1.f )
+		);
+
+		auto const index = _mm256_cvttps_epi32( _mm256_mul_ps( value, _mm256_set1_ps( float(kSrgbLutSize-1) ) ) );
+
+		// Gather the guess as 32 bits and keep the low byte. At the last
+		// entry, this reads three bytes past the table, into the thresholds
+		// that follow it in SrgbLuts.
+		static_assert( offsetof( SrgbLuts, toSrgb ) + kSrgbLutSize + 3 <= sizeof(SrgbLuts), "gather past end" );
+		auto const guess = _mm256_and_si256( 
+			_mm256_i32gather_epi32( reinterpret_cast<int const*>(aLuts.toSrgb), index, 1 ),
+			_mm256_set1_epi32( 0xff )
+		);
+
+		auto const hi = _mm256_i32gather_ps( aLuts.toSrgbThreshold + 1, guess, 4 );
+		auto const lo = _mm256_i32gather_ps( aLuts.toSrgbThreshold, guess, 4 );
+
+		// Comparison masks are -1 where true
+		auto const up = _mm256_castps_si256( _mm256_cmp_ps( value, hi, _CMP_GE_OQ ) );
+		auto const down = _mm256_castps_si256( _mm256_cmp_ps( value, lo, _CMP_LT_OQ ) );
+
+		return _mm256_add_epi32( _mm256_sub_epi32( guess, up ), down );
+	}
+}
+
+#endif // ~ DRAW2D_TRIANGLE_AVX2
@@ -0,0 +1,80 @@
+#ifndef TRIANGLE_KERNELS_HPP_4C0E9A71_2B6D_4F3E_8D15_7A9E3C1B5F20
+#define TRIANGLE_KERNELS_HPP_4C0E9A71_2B6D_4F3E_8D15_7A9E3C1B5F20
+
+// Internal to draw2d: triangle rasterization shared between draw.cpp, the
+// SIMD triangle kernels, the TriangleBinner and the shapes. Not part of the
+// public API.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cpu.hpp"
+#include "draw.hpp"
+#include "color.hpp"
+#include "forward.hpp"
+
+#include "../vmlib/vec2.hpp"
+#include "../vmlib/mat22.hpp"
+
+// The SIMD kernel converts to sRGB with the tables of the LUT mode (see
+// color.hpp). With other modes, only the scalar code is available.
+#if DRAW2D_X86 && DRAW2D_CFG_SRGB_MODE == DRAW2D_CFG_SRGB_LUT
+#	define DRAW2D_TRIANGLE_AVX2 1
+#else
+#	define DRAW2D_TRIANGLE_AVX2 0
+#endif
+
+// Linear color channel as a function of the pixel position:
+//   value( x, y ) = c + dx*x + dy*y
+struct ColorPlane
+{
+	float c, dx, dy;
+};
+
+// The value at pixel (x,y) is computed as
+//   row_value( plane, y ) + dx*(x+0.5)
+// by all code paths, in this order of operations. The result thus depends
+// only on the pixel's position, so the code paths agree to the bit, and a
+// triangle gives the same result no matter how it is split into spans (e.g.,
+// by the tiles of TriangleBinner).
+inline
+float row_value( ColorPlane const& aPlane, int aY ) noexcept
+{
+	return aPlane.c + aPlane.dy * (float(aY) + 0.5f);
+}
+
+// Computes the color planes of a triangle. Returns false if the triangle is
+// degenerate (zero area) and thus covers no pixels.
+bool make_color_planes( ColorPlane aPlanes[3], Vec2f, Vec2f, Vec2f, ColorF const&, ColorF const&, ColorF const& ) noexcept;
+
+// Rasterize a triangle, but only write pixels within aClip, which must lie
+// within the surface. Drawing a triangle once for each rectangle of a
+// partition of the surface gives exactly the same result as drawing it with
+// the whole surface as the clip rectangle, i.e., as draw_triangle_solid() and
+// draw_triangle_interp() do.
+void rasterize_triangle_solid( Surface&, PixelRect const& aClip, Vec2f, Vec2f, Vec2f, ColorU8_sRGB ) noexcept;
+void rasterize_triangle_interp( Surface&, PixelRect const& aClip, Vec2f, Vec2f, Vec2f, ColorPlane const aPlanes[3] ) noexcept;
+
+// Same as draw_triangles_interp() and draw_triangle_fan_interp(), but only
+// write pixels within aClip (see above). The _solid variants fill all
+// triangles with aColor instead; they cover exactly the same pixels.
+void rasterize_triangles_interp( Surface&, PixelRect const& aClip, std::size_t aVertexCount, Vec2f const*, ColorF const*, std::size_t aTriangleCount, std::uint32_t const* aIndices, Mat22f const&, Vec2f );
+void rasterize_triangles_solid( Surface&, PixelRect const& aClip, std::size_t aVertexCount, Vec2f const*, std::size_t aTriangleCount, std::uint32_t const* aIndices, Mat22f const&, Vec2f, ColorU8_sRGB aColor );
+void rasterize_triangle_fan_interp( Surface&, PixelRect const& aClip, std::size_t aCount, Vec2f const*, ColorF const*, Mat22f const&, Vec2f );
+void rasterize_triangle_fan_solid( Surface&, PixelRect const& aClip, std::size_t aCount, Vec2f const*, Mat22f const&, Vec2f, ColorU8_sRGB aColor );
+
+// Checks if the three vertex colors convert to the same sRGB color (after
+// clamping to [0,1]), and if so, returns that color in aColor. All code paths
+// fill such triangles with aColor instead of interpolating. The interpolated
+// colors lie between the vertex colors, so this differs from interpolation
+// by at most one sRGB step, and only where rounding in the plane equations
+// pushes a value across a step boundary.
+bool uniform_color( ColorF const&, ColorF const&, ColorF const&, ColorU8_sRGB& aColor ) noexcept;
+
+// Shades the pixels [aX0,aX1) of row aY, where aRow points to the row's first
+// pixel. aPlanes holds the red, green and blue channels. Values are clamped
+// to [0,1] and converted with linear_to_srgb(). Same results as the scalar
+// code in draw_triangle_interp(). Requires ESimdLevel::avx2 (see cpu.hpp).
+void shade_span_interp_avx2( std::uint32_t* aRow, int aX0, int aX1, int aY, ColorPlane const aPlanes[3] ) noexcept;
+
+#endif // TRIANGLE_KERNELS_HPP_4C0E9A71_2B6D_4F3E_8D15_7A9E3C1B5F20
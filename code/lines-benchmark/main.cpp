@@ -1,6 +1,12 @@
 #include <benchmark/benchmark.h>
 
+#include <random>
+#include <vector>
+
+#include "../draw2d/cpu.hpp"
+#include "../draw2d/color.hpp"
 #include "../draw2d/draw.hpp"
+#include "../draw2d/stroke.hpp"
 #include "../draw2d/surface.hpp"
 
 namespace
@@ -283,6 +289,458 @@ namespace
 			benchmark::ClobberMemory();
 		}
 	}
+	//////////////////////////////////////
+
+	void d_my_original_line_alg_(benchmark::State& aState)
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		Surface surface(width, height);
+		surface.clear();
+
+		for (auto _ : aState)
+		{//far off-screen endpoints, only a small part is visible
+			draw_line_solid(surface,
+				{ -1e6f, -1e6f },
+				{ 1e6f, 1e6f },
+				{ 255, 255, 255 }
+			);
+			benchmark::ClobberMemory();
+		}
+	}
+
+	// Benchmark function for the DDA algorithm
+	void d_my_dda_floats_line_alg_(benchmark::State& aState)
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		Surface surface(width, height);
+		surface.clear();
+
+		for (auto _ : aState)
+		{//far off-screen endpoints, only a small part is visible
+			draw_line_dda_floats_(surface,
+				{ -1e6f, -1e6f },
+				{ 1e6f, 1e6f },
+				{ 255, 255, 255 }
+			);
+			benchmark::ClobberMemory();
+		}
+	}
+	void d_my_dda_integer_line_alg_(benchmark::State& aState)
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		Surface surface(width, height);
+		surface.clear();
+
+		for (auto _ : aState)
+		{//far off-screen endpoints, only a small part is visible
+			draw_line_dda_integer_(surface,
+				{ -1e6f, -1e6f },
+				{ 1e6f, 1e6f },
+				{ 255, 255, 255 }
+			);
+			benchmark::ClobberMemory();
+		}
+	}
+	//////////////////////////////////////
+
+	void e_my_original_line_alg_(benchmark::State& aState)
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		Surface surface(width, height);
+		surface.clear();
+
+		for (auto _ : aState)
+		{//crosses the whole screen diagonally, both ends outside
+			draw_line_solid(surface,
+				{ -10.f, height + 10.f },
+				{ width + 10.f, -10.f },
+				{ 255, 255, 255 }
+			);
+			benchmark::ClobberMemory();
+		}
+	}
+
+	// Benchmark function for the DDA algorithm
+	void e_my_dda_floats_line_alg_(benchmark::State& aState)
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		Surface surface(width, height);
+		surface.clear();
+
+		for (auto _ : aState)
+		{//crosses the whole screen diagonally, both ends outside
+			draw_line_dda_floats_(surface,
+				{ -10.f, height + 10.f },
+				{ width + 10.f, -10.f },
+				{ 255, 255, 255 }
+			);
+			benchmark::ClobberMemory();
+		}
+	}
+	void e_my_dda_integer_line_alg_(benchmark::State& aState)
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		Surface surface(width, height);
+		surface.clear();
+
+		for (auto _ : aState)
+		{//crosses the whole screen diagonally, both ends outside
+			draw_line_dda_integer_(surface,
+				{ -10.f, height + 10.f },
+				{ width + 10.f, -10.f },
+				{ 255, 255, 255 }
+			);
+			benchmark::ClobberMemory();
+		}
+	}
+	// 10k random segments, with end points between -10% and 110% of the
+	// surface size (so some are clipped). The seed is fixed, so all variants
+	// draw the same segments.
+	struct RandomSegments_
+	{
+		std::vector<float> x0, y0, x1, y1;
+		std::vector<ColorU8_sRGB> colors;
+	};
+
+	RandomSegments_ make_random_segments_(std::uint32_t aWidth, std::uint32_t aHeight)
+	{
+		constexpr std::size_t kSegmentCount = 10000;
+
+		std::minstd_rand rng(12345);
+		std::uniform_real_distribution<float> xdist(-0.1f * aWidth, 1.1f * aWidth);
+		std::uniform_real_distribution<float> ydist(-0.1f * aHeight, 1.1f * aHeight);
+		std::uniform_int_distribution<int> cdist(0, 255);
+
+		RandomSegments_ ret;
+		for (std::size_t i = 0; i < kSegmentCount; ++i)
+		{
+			ret.x0.emplace_back(xdist(rng));
+			ret.y0.emplace_back(ydist(rng));
+			ret.x1.emplace_back(xdist(rng));
+			ret.y1.emplace_back(ydist(rng));
+			ret.colors.emplace_back(ColorU8_sRGB{
+				std::uint8_t(cdist(rng)),
+				std::uint8_t(cdist(rng)),
+				std::uint8_t(cdist(rng))
+			});
+		}
+
+		return ret;
+	}
+
+	void g_random_segments_single_(benchmark::State& aState)
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		Surface surface(width, height);
+		surface.clear();
+
+		auto const segs = make_random_segments_(width, height);
+
+		for (auto _ : aState)
+		{//one draw_line_solid() call per segment
+			for (std::size_t i = 0; i < segs.x0.size(); ++i)
+			{
+				draw_line_solid(surface,
+					{ segs.x0[i], segs.y0[i] },
+					{ segs.x1[i], segs.y1[i] },
+					segs.colors[i]
+				);
+			}
+			benchmark::ClobberMemory();
+		}
+	}
+	void g_random_segments_batch_(benchmark::State& aState, ELineOrder aOrder)
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		Surface surface(width, height);
+		surface.clear();
+
+		auto const segs = make_random_segments_(width, height);
+
+		for (auto _ : aState)
+		{//all segments in one draw_lines_solid() call
+			draw_lines_solid(surface, segs.x0.size(),
+				segs.x0.data(), segs.y0.data(),
+				segs.x1.data(), segs.y1.data(),
+				segs.colors.data(),
+				aOrder
+			);
+			benchmark::ClobberMemory();
+		}
+	}
+
+	// 10k short segments (up to 32 pixels), e.g., a dense wireframe. Compares
+	// the scalar code with the multi-line SIMD kernel.
+	void h_short_segments_(benchmark::State& aState, ESimdLevel aLevel)
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		if (aLevel > detected_simd_level())
+		{
+			aState.SkipWithError("SIMD level not supported by this CPU");
+			return;
+		}
+
+		Surface surface(width, height);
+		surface.clear();
+
+		constexpr std::size_t kSegmentCount = 10000;
+
+		std::minstd_rand rng(12345);
+		std::uniform_real_distribution<float> xdist(0.f, float(width));
+		std::uniform_real_distribution<float> ydist(0.f, float(height));
+		std::uniform_real_distribution<float> ddist(-16.f, 16.f);
+
+		std::vector<float> x0, y0, x1, y1;
+		for (std::size_t i = 0; i < kSegmentCount; ++i)
+		{
+			x0.emplace_back(xdist(rng));
+			y0.emplace_back(ydist(rng));
+			x1.emplace_back(x0.back() + ddist(rng));
+			y1.emplace_back(y0.back() + ddist(rng));
+		}
+
+		set_simd_level_limit(aLevel);
+
+		for (auto _ : aState)
+		{
+			draw_lines_solid(surface, kSegmentCount,
+				x0.data(), y0.data(), x1.data(), y1.data(),
+				ColorU8_sRGB{ 255, 255, 255 }
+			);
+			benchmark::ClobberMemory();
+		}
+
+		set_simd_level_limit(ESimdLevel::avx2);
+
+		aState.counters["lines"] = benchmark::Counter(
+			float(kSegmentCount),
+			benchmark::Counter::kIsIterationInvariantRate
+		);
+	}
+
+	// Smooth wireframes: the random segments from above, drawn either as
+	// solid lines, as anti-aliased lines, or as solid lines at twice the
+	// resolution that are then downsampled (2x2 box filter in linear space).
+	enum class EWireframeMode_
+	{
+		solid,
+		aa,
+		supersample
+	};
+
+	void downsample_2x_(Surface& aTarget, Surface const& aSource)
+	{
+		auto const* src = aSource.get_surface_ptr();
+		auto const width = aTarget.get_width();
+		auto const height = aTarget.get_height();
+
+		for (Surface::Index y = 0; y < height; ++y)
+		{
+			for (Surface::Index x = 0; x < width; ++x)
+			{
+				auto const* p00 = src + aSource.get_linear_index(2*x, 2*y);
+				auto const* p10 = src + aSource.get_linear_index(2*x+1, 2*y);
+				auto const* p01 = src + aSource.get_linear_index(2*x, 2*y+1);
+				auto const* p11 = src + aSource.get_linear_index(2*x+1, 2*y+1);
+
+				std::uint8_t out[3];
+				for (int c = 0; c < 3; ++c)
+				{
+					float const sum = linear_from_srgb_lut(p00[c]) + linear_from_srgb_lut(p10[c])
+						+ linear_from_srgb_lut(p01[c]) + linear_from_srgb_lut(p11[c]);
+					out[c] = linear_to_srgb_lut(0.25f * sum);
+				}
+
+				aTarget.set_pixel_srgb(x, y, { out[0], out[1], out[2] });
+			}
+		}
+	}
+
+	void i_wireframe_(benchmark::State& aState, EWireframeMode_ aMode)
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		Surface surface(width, height);
+		surface.clear();
+
+		auto const segs = make_random_segments_(width, height);
+
+		if (EWireframeMode_::supersample == aMode)
+		{
+			Surface large(2*width, 2*height);
+
+			for (auto _ : aState)
+			{
+				large.clear();
+				for (std::size_t i = 0; i < segs.x0.size(); ++i)
+				{
+					draw_line_solid(large,
+						{ 2.f*segs.x0[i], 2.f*segs.y0[i] },
+						{ 2.f*segs.x1[i], 2.f*segs.y1[i] },
+						segs.colors[i]
+					);
+				}
+
+				downsample_2x_(surface, large);
+				benchmark::ClobberMemory();
+			}
+
+			return;
+		}
+
+		for (auto _ : aState)
+		{
+			surface.clear();
+			for (std::size_t i = 0; i < segs.x0.size(); ++i)
+			{
+				Vec2f const begin{ segs.x0[i], segs.y0[i] };
+				Vec2f const end{ segs.x1[i], segs.y1[i] };
+
+				if (EWireframeMode_::aa == aMode)
+					draw_line_aa(surface, begin, end, segs.colors[i]);
+				else
+					draw_line_solid(surface, begin, end, segs.colors[i]);
+			}
+			benchmark::ClobberMemory();
+		}
+	}
+
+	// Thick polyline (200 random points on a 1280x720 surface) with a width of
+	// aState.range(0) pixels. Either drawn as aWidth parallel 1-pixel lines
+	// per segment (offset along the segment's normal), or stroked into
+	// triangles that are drawn in one go.
+	enum class EThickMode_
+	{
+		offsetLines,
+		strokeMiter,
+		strokeRound
+	};
+
+	void k_thick_polyline_(benchmark::State& aState, EThickMode_ aMode)
+	{
+		auto const width = float(aState.range(0));
+
+		Surface surface(1280, 720);
+		surface.clear();
+
+		constexpr std::size_t kPointCount = 200;
+
+		std::minstd_rand rng(12345);
+		std::uniform_real_distribution<float> xdist(0.f, 1280.f);
+		std::uniform_real_distribution<float> ydist(0.f, 720.f);
+
+		std::vector<Vec2f> points;
+		for (std::size_t i = 0; i < kPointCount; ++i)
+			points.emplace_back(Vec2f{ xdist(rng), ydist(rng) });
+
+		StrokeStyle style;
+		style.width = width;
+		style.join = EThickMode_::strokeRound == aMode ? ELineJoin::round : ELineJoin::miter;
+
+		std::vector<Vec2f> triangles;
+		for (auto _ : aState)
+		{
+			if (EThickMode_::offsetLines == aMode)
+			{
+				for (std::size_t i = 0; i+1 < kPointCount; ++i)
+				{
+					auto const delta = points[i+1] - points[i];
+					auto const normal = Vec2f{ -delta.y, delta.x } / length(delta);
+
+					for (int k = 0; k < int(width); ++k)
+					{
+						auto const offset = (float(k) - 0.5f * (width - 1.f)) * normal;
+						draw_line_solid(surface, points[i] + offset, points[i+1] + offset, { 255, 255, 255 });
+					}
+				}
+			}
+			else
+			{
+				triangles.clear();
+				stroke_polyline(triangles, points.size(), points.data(), style);
+				draw_triangles_solid(surface, triangles.size() / 3, triangles.data(), { 255, 255, 255 });
+			}
+
+			benchmark::ClobberMemory();
+		}
+	}
+
+	// Line of aLength pixels along its major axis, going in the direction
+	// (aDirX, aDirY). The surface is just large enough to fit the line, so
+	// nothing is clipped. Reports the number of pixels drawn per second.
+	// With a non-zero aSubpixel, the end points are moved by that fraction
+	// of a pixel, so they are no longer at pixel corners.
+	void f_line_length_(benchmark::State& aState, float aDirX, float aDirY, float aSubpixel = 0.f)
+	{
+		auto const length = float(aState.range(0));
+
+		auto const dx = length * aDirX;
+		auto const dy = length * aDirY;
+
+		Surface surface(std::uint32_t(dx) + 1, std::uint32_t(dy) + 1);
+		surface.clear();
+
+		for (auto _ : aState)
+		{
+			draw_line_solid(surface,
+				{ aSubpixel, aSubpixel },
+				{ dx + aSubpixel, dy + aSubpixel },
+				{ 255, 255, 255 }
+			);
+			benchmark::ClobberMemory();
+		}
+
+		aState.counters["pixels"] = benchmark::Counter(
+			length + 1.f,
+			benchmark::Counter::kIsIterationInvariantRate
+		);
+	}
+
+	// Anti-aliased shallow line of aLength columns. Either the line stays
+	// inside of the surface (its columns are plotted without per-pixel
+	// bounds checks), or it starts and ends half a pixel above and below
+	// the surface, so each column is checked.
+	void l_line_aa_(benchmark::State& aState, bool aCrossing)
+	{
+		auto const length = float(aState.range(0));
+		auto const height = length / 8.f;
+
+		Surface surface(std::uint32_t(length) + 2, std::uint32_t(height) + 2);
+		surface.clear();
+
+		Vec2f const begin{ 1.f, aCrossing ? -0.5f : 1.5f };
+		Vec2f const end{ length + 1.f, aCrossing ? height + 2.5f : height + 0.5f };
+
+		for (auto _ : aState)
+		{
+			draw_line_aa(surface, begin, end, { 255, 255, 255 });
+			benchmark::ClobberMemory();
+		}
+
+		aState.counters["columns"] = benchmark::Counter(
+			length,
+			benchmark::Counter::kIsIterationInvariantRate
+		);
+	}
 }
 
 BENCHMARK(a_my_original_line_alg_)
@@ -348,5 +806,172 @@ BENCHMARK(c_my_dda_integer_line_alg_)
 ->Args({ 7680, 4320 })
 ;
 
+///
+BENCHMARK(d_my_original_line_alg_)
+->Args({ 320, 240 })
+->Args({ 1280, 720 })
+->Args({ 1920, 1080 })
+->Args({ 7680, 4320 })
+;
+
+BENCHMARK(d_my_dda_floats_line_alg_)
+->Args({ 320, 240 })
+->Args({ 1280, 720 })
+->Args({ 1920, 1080 })
+->Args({ 7680, 4320 })
+;
+
+BENCHMARK(d_my_dda_integer_line_alg_)
+->Args({ 320, 240 })
+->Args({ 1280, 720 })
+->Args({ 1920, 1080 })
+->Args({ 7680, 4320 })
+;
+
+///
+BENCHMARK(e_my_original_line_alg_)
+->Args({ 320, 240 })
+->Args({ 1280, 720 })
+->Args({ 1920, 1080 })
+->Args({ 7680, 4320 })
+;
+
+BENCHMARK(e_my_dda_floats_line_alg_)
+->Args({ 320, 240 })
+->Args({ 1280, 720 })
+->Args({ 1920, 1080 })
+->Args({ 7680, 4320 })
+;
+
+BENCHMARK(e_my_dda_integer_line_alg_)
+->Args({ 320, 240 })
+->Args({ 1280, 720 })
+->Args({ 1920, 1080 })
+->Args({ 7680, 4320 })
+;
+
+///
+BENCHMARK_CAPTURE(f_line_length_, shallow, 1.f, 0.25f)
+->Arg(10)
+->Arg(100)
+->Arg(1000)
+->Arg(8000)
+;
+BENCHMARK_CAPTURE(f_line_length_, steep, 0.25f, 1.f)
+->Arg(10)
+->Arg(100)
+->Arg(1000)
+->Arg(8000)
+;
+BENCHMARK_CAPTURE(f_line_length_, diagonal, 1.f, 1.f)
+->Arg(10)
+->Arg(100)
+->Arg(1000)
+->Arg(8000)
+;
+BENCHMARK_CAPTURE(f_line_length_, horizontal, 1.f, 0.f)
+->Arg(10)
+->Arg(100)
+->Arg(1000)
+->Arg(8000)
+;
+BENCHMARK_CAPTURE(f_line_length_, vertical, 0.f, 1.f)
+->Arg(10)
+->Arg(100)
+->Arg(1000)
+->Arg(8000)
+;
+BENCHMARK_CAPTURE(f_line_length_, shallow_subpixel, 1.f, 0.25f, 0.3f)
+->Arg(10)
+->Arg(100)
+->Arg(1000)
+->Arg(8000)
+;
+BENCHMARK_CAPTURE(f_line_length_, steep_subpixel, 0.25f, 1.f, 0.3f)
+->Arg(10)
+->Arg(100)
+->Arg(1000)
+->Arg(8000)
+;
+
+///
+BENCHMARK(g_random_segments_single_)
+	->Args({ 320, 240 })
+	->Args({ 1280, 720 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(g_random_segments_batch_, submission, ELineOrder::submission)
+	->Args({ 320, 240 })
+	->Args({ 1280, 720 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(g_random_segments_batch_, band, ELineOrder::band)
+	->Args({ 320, 240 })
+	->Args({ 1280, 720 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(h_short_segments_, scalar, ESimdLevel::scalar)
+	->Args({ 320, 240 })
+	->Args({ 1280, 720 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(h_short_segments_, avx2, ESimdLevel::avx2)
+	->Args({ 320, 240 })
+	->Args({ 1280, 720 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+
+BENCHMARK_CAPTURE(k_thick_polyline_, offset_lines, EThickMode_::offsetLines)
+	->Arg(2)
+	->Arg(4)
+	->Arg(8)
+	->Arg(16)
+;
+BENCHMARK_CAPTURE(k_thick_polyline_, stroke_miter, EThickMode_::strokeMiter)
+	->Arg(2)
+	->Arg(4)
+	->Arg(8)
+	->Arg(16)
+;
+BENCHMARK_CAPTURE(k_thick_polyline_, stroke_round, EThickMode_::strokeRound)
+	->Arg(2)
+	->Arg(4)
+	->Arg(8)
+	->Arg(16)
+;
+
+// Note: no 7680x4320 here; the 2x surface for supersampling would need over
+// 500MB.
+BENCHMARK_CAPTURE(i_wireframe_, solid, EWireframeMode_::solid)
+	->Args({ 320, 240 })
+	->Args({ 1280, 720 })
+	->Args({ 1920, 1080 })
+;
+BENCHMARK_CAPTURE(i_wireframe_, aa, EWireframeMode_::aa)
+	->Args({ 320, 240 })
+	->Args({ 1280, 720 })
+	->Args({ 1920, 1080 })
+;
+BENCHMARK_CAPTURE(i_wireframe_, supersample, EWireframeMode_::supersample)
+	->Args({ 320, 240 })
+	->Args({ 1280, 720 })
+	->Args({ 1920, 1080 })
+;
+
+BENCHMARK_CAPTURE(l_line_aa_, inside, false)
+	->Arg(100)
+	->Arg(1000)
+	->Arg(8000)
+;
+BENCHMARK_CAPTURE(l_line_aa_, crossing, true)
+	->Arg(100)
+	->Arg(1000)
+	->Arg(8000)
+;
 
 BENCHMARK_MAIN();
@@ -221,60 +221,25 @@ int main( int aArgc, char* aArgv[] ) try
 
 			case 5: {
 				// Additional tests 1 Intersecting Lines
-				draw_line_solid(surface,
-					{ 150.f, 150.f },
-					{ 400.f, 400.f },
-					{ 255, 255, 255 }
-				);
+				float const x0[] = { 150.f, 400.f };
+				float const y0[] = { 150.f, 150.f };
+				float const x1[] = { 400.f, 150.f };
+				float const y1[] = { 400.f, 400.f };
 
-				draw_line_solid(surface,
-					{ 400.f, 150.f },
-					{ 150.f, 400.f },
-					{ 255, 255, 255 }
-				);
+				draw_lines_solid( surface, 2, x0, y0, x1, y1, { 255, 255, 255 } );
 			} break;
 
 			case 6: {
 				// Additional tests 2 Parallel lines
-				//Parallel Lines Test, far apart
-				draw_line_solid(surface,
-					{ 40.f, 150.f },
-					{ 700.f, 150.f },
-					{ 255, 255, 255 }
-				);
-
-				draw_line_solid(surface,
-					{ 40.f, 200.f },
-					{ 700.f, 200.f },
-					{ 255, 255, 255 }
-				);
-
-				//this is basically overlapping the lines
-				draw_line_solid(surface,
-					{ 140.f, 250.f },
-					{ 900.f, 250.f },
-					{ 255, 255, 255 }
-				);
-
-				draw_line_solid(surface,
-					{ 140.f, 250.f },
-					{ 900.f, 250.f },
-					{ 255, 255, 255 }
-				);
-
-
-				//you can see the line is doubled
-				draw_line_solid(surface,
-					{ 240.f, 350.f },
-					{ 1000.f, 350.f },
-					{ 255, 255, 255 }
-				);
-
-				draw_line_solid(surface,
-					{ 240.f, 351.f },
-					{ 1000.f, 351.f },
-					{ 255, 255, 255 }
-				);
+				// - lines 0, 1: parallel lines, far apart
+				// - lines 2, 3: this is basically overlapping the lines
+				// - lines 4, 5: you can see the line is doubled
+				float const x0[] = {  40.f,  40.f, 140.f, 140.f,  240.f,  240.f };
+				float const y0[] = { 150.f, 200.f, 250.f, 250.f,  350.f,  351.f };
+				float const x1[] = { 700.f, 700.f, 900.f, 900.f, 1000.f, 1000.f };
+				float const y1[] = { 150.f, 200.f, 250.f, 250.f,  350.f,  351.f };
+
+				draw_lines_solid( surface, 6, x0, y0, x1, y1, { 255, 255, 255 } );
 			} break;	
 
 			case 7: {
@@ -290,20 +255,12 @@ int main( int aArgc, char* aArgv[] ) try
 
 			case 8: {
 				// Additional tests 4 Consecutive Lines with No Gaps
-				draw_line_solid(surface,
-					{ 50.f, 100.f },
-					{ 100.f, 100.f },
-					{ 255, 255, 255 }
-				);
+				// we take the end point of the first line and use it as the
+				// start point for the second line
+				float const xs[] = { 50.f, 100.f, 150.f };
+				float const ys[] = { 100.f, 100.f, 100.f };
 
-				// we take the end point of the first line and use it as the start point for the second line
-				Vec2f startPoint = { 100.f, 100.f };
-
-				draw_line_solid(surface,
-					startPoint,  // we start at the end of the first line
-					{ 150.f, 100.f },  // and extend to a new end point
-					{ 255, 255, 255 }
-				);
+				draw_lines_solid( surface, 2, xs, ys, xs+1, ys+1, { 255, 255, 255 } );
 			} break;
 
 			case 9: {
@@ -0,0 +1,152 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "helpers.hpp"
+
+#include "../draw2d/surface.hpp"
+#include "../draw2d/draw.hpp"
+#include "../draw2d/color.hpp"
+
+namespace
+{
+	std::uint8_t const* pixel_( Surface const& aSurface, Surface::Index aX, Surface::Index aY )
+	{
+		return aSurface.get_surface_ptr() + aSurface.get_linear_index( aX, aY );
+	}
+}
+
+TEST_CASE( "Anti-aliased lines", "[aa]" )
+{
+	Surface surface( 64, 64 );
+	surface.clear();
+
+	SECTION( "pixel aligned" )
+	{
+		// The line runs through the centers of the pixels in row 10, so these
+		// are fully covered, and the rows above and below remain untouched.
+		draw_line_aa( surface,
+			{ 2.f, 10.5f },
+			{ 20.f, 10.5f },
+			{ 255, 128, 0 }
+		);
+
+		REQUIRE( 18 == max_row_pixel_count( surface ) );
+		REQUIRE( 1 == max_col_pixel_count( surface ) );
+
+		for( Surface::Index x = 2; x < 20; ++x )
+		{
+			auto const* pix = pixel_( surface, x, 10 );
+			REQUIRE( 255 == int(pix[0]) );
+			REQUIRE( 128 == int(pix[1]) );
+			REQUIRE( 0 == int(pix[2]) );
+		}
+	}
+
+	SECTION( "between rows" )
+	{
+		// Halfway between two columns, each column receives half of the color (in
+		// linear space).
+		draw_line_aa( surface,
+			{ 13.f, 4.f },
+			{ 13.f, 40.f },
+			{ 255, 255, 255 }
+		);
+
+		auto const half = int(linear_to_srgb( 0.5f ));
+		for( Surface::Index y = 4; y < 40; ++y )
+		{
+			REQUIRE( std::abs( half - int(pixel_( surface, 12, y )[0]) ) <= 1 );
+			REQUIRE( std::abs( half - int(pixel_( surface, 13, y )[0]) ) <= 1 );
+		}
+
+		REQUIRE( 2 == max_row_pixel_count( surface ) );
+		REQUIRE( 36 == max_col_pixel_count( surface ) );
+	}
+}
+
+TEST_CASE( "Anti-aliased lines are clipped", "[aa][clip]" )
+{
+	// Draw the same lines to a large surface and (offset) to a small one. The
+	// small surface must match the corresponding part of the large one.
+	Surface large( 256, 256 );
+	Surface small( 128, 128 );
+
+	constexpr float off = 64.f;
+
+	auto const test = [&] (Vec2f aBegin, Vec2f aEnd) {
+		large.clear();
+		small.clear();
+
+		draw_line_aa( large, aBegin, aEnd, { 255, 255, 255 } );
+		draw_line_aa( small, 
+			{ aBegin.x - off, aBegin.y - off },
+			{ aEnd.x - off, aEnd.y - off },
+			{ 255, 255, 255 }
+		);
+
+		for( Surface::Index y = 0; y < 128; ++y )
+		{
+			for( Surface::Index x = 0; x < 128; ++x )
+			{
+				auto const* a = pixel_( large, x+64, y+64 );
+				auto const* b = pixel_( small, x, y );
+				REQUIRE( a[0] == b[0] );
+			}
+		}
+	};
+
+	SECTION( "shallow" )
+	{
+		test( { 16.25f, 40.5f }, { 272.25f, 136.5f } );
+	}
+	SECTION( "steep" )
+	{
+		test( { 100.75f, 2.f }, { 76.75f, 130.f } );
+	}
+	SECTION( "through" )
+	{
+		test( { 0.5f, 250.f }, { 256.5f, 58.f } );
+	}
+	SECTION( "far away" )
+	{
+		// Slope 3/8; the end points are far outside of both surfaces
+		large.clear();
+		small.clear();
+
+		draw_line_aa( large, { -16384.f, -6144.f+20.f }, { 16384.f, 6144.f+20.f }, { 255, 255, 255 } );
+		draw_line_aa( small, { -16384.f-off, -6144.f+20.f-off }, { 16384.f-off, 6144.f+20.f-off }, { 255, 255, 255 } );
+
+		std::size_t lit = 0;
+		for( Surface::Index y = 0; y < 128; ++y )
+		{
+			for( Surface::Index x = 0; x < 128; ++x )
+			{
+				REQUIRE( pixel_( large, x+64, y+64 )[0] == pixel_( small, x, y )[0] );
+				lit += pixel_( small, x, y )[0] ? 1 : 0;
+			}
+		}
+		REQUIRE( lit > 0 );
+	}
+}
+
+TEST_CASE( "sRGB tables", "[aa][srgb]" )
+{
+	for( int i = 0; i < 256; ++i )
+	{
+		auto const value = std::uint8_t(i);
+		REQUIRE( linear_from_srgb( value ) == linear_from_srgb_lut( value ) );
+		REQUIRE( value == linear_to_srgb_lut( linear_from_srgb_lut( value ) ) );
+		REQUIRE( value == linear_to_srgb_lut12( linear_from_srgb_lut12( value ) ) );
+	}
+
+	for( int i = 0; i <= 1000; ++i )
+	{
+		float const lin = float(i) / 1000.f;
+		REQUIRE( std::abs( int(linear_to_srgb( lin )) - int(linear_to_srgb_lut( lin )) ) <= 1 );
+	}
+
+	REQUIRE( 0 == linear_to_srgb_lut( -1.f ) );
+	REQUIRE( 255 == linear_to_srgb_lut( 2.f ) );
+}
@@ -0,0 +1,134 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <random>
+#include <vector>
+
+#include <cstring>
+
+#include "helpers.hpp"
+
+#include "../draw2d/cpu.hpp"
+#include "../draw2d/surface.hpp"
+#include "../draw2d/draw.hpp"
+
+
+TEST_CASE( "Batch matches single lines", "[batch]" )
+{
+	constexpr std::uint32_t kWidth = 320, kHeight = 240;
+	constexpr std::size_t kCount = 500;
+
+	// Random segments, some of which extend outside of the surface.
+	std::minstd_rand rng( 42 );
+	std::uniform_real_distribution<float> xdist( -50.f, kWidth+50.f );
+	std::uniform_real_distribution<float> ydist( -50.f, kHeight+50.f );
+	std::uniform_int_distribution<int> cdist( 0, 255 );
+
+	std::vector<float> x0, y0, x1, y1;
+	std::vector<ColorU8_sRGB> colors;
+	for( std::size_t i = 0; i < kCount; ++i )
+	{
+		x0.emplace_back( xdist( rng ) );
+		y0.emplace_back( ydist( rng ) );
+		x1.emplace_back( xdist( rng ) );
+		y1.emplace_back( ydist( rng ) );
+		colors.emplace_back( ColorU8_sRGB{ 
+			std::uint8_t(cdist( rng )), 
+			std::uint8_t(cdist( rng )), 
+			std::uint8_t(cdist( rng ))
+		} );
+	}
+
+	SECTION( "submission order" )
+	{
+		Surface single( kWidth, kHeight );
+		single.clear();
+		for( std::size_t i = 0; i < kCount; ++i )
+			draw_line_solid( single, { x0[i], y0[i] }, { x1[i], y1[i] }, colors[i] );
+
+		Surface batch( kWidth, kHeight );
+		batch.clear();
+		draw_lines_solid( batch, kCount, x0.data(), y0.data(), x1.data(), y1.data(), colors.data() );
+
+		auto const bytes = std::size_t(single.get_pitch())*kHeight;
+		REQUIRE( 0 == std::memcmp( single.get_surface_ptr(), batch.get_surface_ptr(), bytes ) );
+	}
+
+	// With a single color, the order in which lines are drawn doesn't affect
+	// the result.
+	SECTION( "band order" )
+	{
+		ColorU8_sRGB const color{ 255, 255, 255 };
+
+		Surface single( kWidth, kHeight );
+		single.clear();
+		for( std::size_t i = 0; i < kCount; ++i )
+			draw_line_solid( single, { x0[i], y0[i] }, { x1[i], y1[i] }, color );
+
+		Surface batch( kWidth, kHeight );
+		batch.clear();
+		draw_lines_solid( batch, kCount, x0.data(), y0.data(), x1.data(), y1.data(), color, ELineOrder::band );
+
+		auto const bytes = std::size_t(single.get_pitch())*kHeight;
+		REQUIRE( 0 == std::memcmp( single.get_surface_ptr(), batch.get_surface_ptr(), bytes ) );
+	}
+
+	SECTION( "empty" )
+	{
+		Surface surface( kWidth, kHeight );
+		surface.clear();
+
+		draw_lines_solid( surface, 0, nullptr, nullptr, nullptr, nullptr, ColorU8_sRGB{ 255, 255, 255 } );
+
+		REQUIRE( 0 == max_row_pixel_count( surface ) );
+	}
+}
+
+TEST_CASE( "Batch SIMD matches scalar", "[batch][simd]" )
+{
+	constexpr std::uint32_t kWidth = 160, kHeight = 120;
+	constexpr std::size_t kCount = 2000;
+
+	// Many short and overlapping segments with different colors, so that
+	// the order in which they are drawn matters. A few long ones are mixed
+	// in; these are not handled by the multi-line kernels.
+	std::minstd_rand rng( 7 );
+	std::uniform_real_distribution<float> pdist( -10.f, kWidth+10.f );
+	std::uniform_real_distribution<float> ddist( -40.f, 40.f );
+	std::uniform_int_distribution<int> cdist( 0, 255 );
+
+	std::vector<float> x0, y0, x1, y1;
+	std::vector<ColorU8_sRGB> colors;
+	for( std::size_t i = 0; i < kCount; ++i )
+	{
+		float const scale = (i % 97 == 0) ? 5.f : 1.f;
+		x0.emplace_back( pdist( rng ) );
+		y0.emplace_back( pdist( rng ) * kHeight / kWidth );
+		x1.emplace_back( x0.back() + scale*ddist( rng ) );
+		y1.emplace_back( y0.back() + scale*ddist( rng ) );
+		colors.emplace_back( ColorU8_sRGB{ 
+			std::uint8_t(cdist( rng )), 
+			std::uint8_t(cdist( rng )), 
+			std::uint8_t(cdist( rng ))
+		} );
+	}
+
+	Surface single( kWidth, kHeight );
+	single.clear();
+	for( std::size_t i = 0; i < kCount; ++i )
+		draw_line_solid( single, { x0[i], y0[i] }, { x1[i], y1[i] }, colors[i] );
+
+	auto const level = GENERATE( ESimdLevel::scalar, ESimdLevel::avx2 );
+	if( level > detected_simd_level() )
+		SKIP( "SIMD level not supported by this CPU" );
+
+	set_simd_level_limit( level );
+
+	Surface batch( kWidth, kHeight );
+	batch.clear();
+	draw_lines_solid( batch, kCount, x0.data(), y0.data(), x1.data(), y1.data(), colors.data() );
+
+	set_simd_level_limit( ESimdLevel::avx2 );
+
+	auto const bytes = std::size_t(single.get_pitch())*kHeight;
+	REQUIRE( 0 == std::memcmp( single.get_surface_ptr(), batch.get_surface_ptr(), bytes ) );
+}
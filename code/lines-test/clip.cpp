@@ -28,3 +28,113 @@ TEST_CASE( "Partially offscreen", "[clip]" )
 		REQUIRE( 1 == pixels );
 	}
 }
+
+TEST_CASE( "Far offscreen endpoints", "[clip]" )
+{
+	Surface surface( 640, 480 );
+	surface.clear();
+
+	// The line is clipped analytically, so this should not require stepping
+	// over the millions of invisible pixels.
+	SECTION( "diagonal" )
+	{
+		draw_line_solid( surface,
+			{ -1e6f, -1e6f },
+			{ 1e6f, 1e6f },
+			{ 255, 255, 255 }
+		);
+
+		REQUIRE( 1 == max_row_pixel_count( surface ) );
+		REQUIRE( 1 == max_col_pixel_count( surface ) );
+
+		auto const counts = count_pixel_neighbours( surface );
+		REQUIRE( 0 == counts[0] );
+		REQUIRE( 2 == counts[1] );
+		REQUIRE( 478 == counts[2] );
+	}
+
+	SECTION( "horizontal" )
+	{
+		draw_line_solid( surface,
+			{ -1e6f, 100.f },
+			{ 1e6f, 100.f },
+			{ 255, 255, 255 }
+		);
+
+		REQUIRE( 640 == max_row_pixel_count( surface ) );
+		REQUIRE( 1 == max_col_pixel_count( surface ) );
+	}
+
+	SECTION( "miss corner" )
+	{
+		// Passes just outside of the top-left corner
+		draw_line_solid( surface,
+			{ -1e6f, 1e6f-2.f },
+			{ 1e6f, -1e6f-2.f },
+			{ 255, 255, 255 }
+		);
+
+		REQUIRE( 0 == max_row_pixel_count( surface ) );
+	}
+}
+
+namespace
+{
+	// Count pixels in aSurface that differ from the corresponding pixel in
+	// the (larger) aReference, which is offset by (aOffX, aOffY).
+	std::size_t count_differences_( Surface const& aSurface, Surface const& aReference, std::uint32_t aOffX, std::uint32_t aOffY )
+	{
+		std::size_t res = 0;
+
+		auto const stride = aSurface.get_pitch();
+		auto const refStride = aReference.get_pitch();
+		for( std::uint32_t y = 0; y < aSurface.get_height(); ++y )
+		{
+			for( std::uint32_t x = 0; x < aSurface.get_width(); ++x )
+			{
+				auto const ptr = aSurface.get_surface_ptr() + y*stride + (x<<2);
+				auto const qtr = aReference.get_surface_ptr() + (y+aOffY)*refStride + ((x+aOffX)<<2);
+
+				if( ptr[0] != qtr[0] || ptr[1] != qtr[1] || ptr[2] != qtr[2] )
+					++res;
+			}
+		}
+
+		return res;
+	}
+}
+
+TEST_CASE( "Clipped matches unclipped", "[clip]" )
+{
+	// Clipping must not change which pixels are drawn. Draw the same lines
+	// into a small surface, where they are clipped, and into a large one,
+	// where they fit entirely, and compare the overlapping region.
+	Surface surface( 64, 48 );
+	surface.clear();
+
+	constexpr std::uint32_t kOffset = 256;
+	Surface reference( 64 + 2*kOffset, 48 + 2*kOffset );
+	reference.clear();
+
+	Vec2f const lines[][2] = {
+		{ { -100.f, -37.f }, { 150.f, 91.f } },
+		{ { 150.f, 91.f }, { -100.f, -37.f } },
+		{ { -20.f, 200.f }, { 70.f, -150.f } },
+		{ { 70.f, -150.f }, { -20.f, 200.f } },
+		{ { -3.f, 5.f }, { 200.f, 11.f } },
+		{ { 31.f, -60.f }, { 33.f, 100.f } },
+		{ { -50.f, 47.f }, { 120.f, -1.f } },
+		{ { 63.f, -10.f }, { -10.f, 63.f } },
+	};
+
+	for( auto const& line : lines )
+	{
+		draw_line_solid( surface, line[0], line[1], { 255, 255, 255 } );
+
+		Vec2f const off{ float(kOffset), float(kOffset) };
+		draw_line_solid( reference, line[0] + off, line[1] + off, { 255, 255, 255 } );
+	}
+
+	REQUIRE( 0 == count_differences_( surface, reference, kOffset, kOffset ) );
+	REQUIRE( 0 != max_row_pixel_count( surface ) );
+}
@@ -10,7 +10,7 @@ std::size_t max_row_pixel_count( Surface const& aSurface )
 {
 	std::size_t res = 0;
 
-	auto const stride = aSurface.get_width() << 2;
+	auto const stride = aSurface.get_pitch();
 	for( std::uint32_t y = 0; y < aSurface.get_height(); ++y )
 	{
 		std::size_t inRow = 0;
@@ -39,7 +39,7 @@ std::size_t max_col_pixel_count( Surface const& aSurface )
 {
 	std::size_t res = 0;
 
-	auto const stride = aSurface.get_width() << 2;
+	auto const stride = aSurface.get_pitch();
 	for( std::uint32_t x = 0; x < aSurface.get_width(); ++x )
 	{
 		std::size_t inCol = 0;
@@ -58,6 +58,26 @@ std::size_t max_col_pixel_count( Surface const& aSurface )
 	return res;
 }
 
+std::size_t count_lit_pixels( Surface const& aSurface )
+{
+	std::size_t res = 0;
+
+	auto const stride = aSurface.get_pitch();
+	for( std::uint32_t y = 0; y < aSurface.get_height(); ++y )
+	{
+		for( std::uint32_t x = 0; x < aSurface.get_width(); ++x )
+		{
+			auto const idx = y*stride + (x<<2);
+			auto const ptr = aSurface.get_surface_ptr() + idx;
+
+			if( ptr[0] > 0 || ptr[1] > 0 || ptr[2] > 0 )
+				++res;
+		}
+	}
+
+	return res;
+}
+
 
 std::array<std::size_t,9> count_pixel_neighbours( Surface const& aSurface )
 {
@@ -74,7 +94,7 @@ std::array<std::size_t,9> count_pixel_neighbours( Surface const& aSurface )
 	// diagonals (4).
 	static_assert( sizeof(kNeighbourOffsets)/sizeof(kNeighbourOffsets[0]) == 8 );
 
-	auto const stride = aSurface.get_width() << 2;
+	auto const stride = aSurface.get_pitch();
 	for( std::uint32_t yp = 0; yp < aSurface.get_height(); ++yp )
 	{
 		for( std::uint32_t xp = 0; xp < aSurface.get_width(); ++xp )
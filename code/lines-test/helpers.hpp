@@ -10,6 +10,8 @@
 std::size_t max_row_pixel_count( Surface const& );
 std::size_t max_col_pixel_count( Surface const& );
 
+std::size_t count_lit_pixels( Surface const& );
+
 std::array<std::size_t,9> count_pixel_neighbours( Surface const& );
 
 #endif // HELPERS_HPP_D7CD1385_1BA6_4B6B_9F31_72B9B8A05AA7
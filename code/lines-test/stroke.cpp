@@ -0,0 +1,128 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <vector>
+
+#include "helpers.hpp"
+
+#include "../draw2d/surface.hpp"
+#include "../draw2d/stroke.hpp"
+#include "../draw2d/draw.hpp"
+
+namespace
+{
+	std::size_t draw_stroke_( Surface& aSurface, std::vector<Vec2f> const& aPoints, StrokeStyle const& aStyle )
+	{
+		std::vector<Vec2f> triangles;
+		stroke_polyline( triangles, aPoints.size(), aPoints.data(), aStyle );
+		return draw_triangles_solid( aSurface, triangles.size()/3, triangles.data(), { 255, 255, 255 } );
+	}
+}
+
+TEST_CASE( "Stroke caps", "[stroke]" )
+{
+	Surface surface( 64, 64 );
+	surface.clear();
+
+	StrokeStyle style;
+	style.width = 4.f;
+
+	SECTION( "butt" )
+	{
+		style.cap = ELineCap::butt;
+		auto const written = draw_stroke_( surface, { { 10.f, 20.f }, { 50.f, 20.f } }, style );
+
+		REQUIRE( 40 == max_row_pixel_count( surface ) );
+		REQUIRE( 4 == max_col_pixel_count( surface ) );
+		REQUIRE( 160 == written );
+		REQUIRE( 160 == count_lit_pixels( surface ) );
+	}
+
+	SECTION( "square" )
+	{
+		style.cap = ELineCap::square;
+		auto const written = draw_stroke_( surface, { { 10.f, 20.f }, { 50.f, 20.f } }, style );
+
+		REQUIRE( 44 == max_row_pixel_count( surface ) );
+		REQUIRE( 4 == max_col_pixel_count( surface ) );
+		REQUIRE( 176 == written );
+	}
+
+	SECTION( "degenerate" )
+	{
+		REQUIRE( 0 == draw_stroke_( surface, { { 10.f, 20.f }, { 10.f, 20.f } }, style ) );
+
+		style.width = 0.f;
+		REQUIRE( 0 == draw_stroke_( surface, { { 10.f, 20.f }, { 50.f, 20.f } }, style ) );
+
+		REQUIRE( 0 == count_lit_pixels( surface ) );
+	}
+}
+
+TEST_CASE( "Stroke joins", "[stroke]" )
+{
+	Surface surface( 64, 64 );
+	surface.clear();
+
+	// Right angle. The miter fills the outer corner completely:
+	// [10,43) x [7,13) plus [37,43) x [13,40).
+	std::vector<Vec2f> const corner{ { 10.f, 10.f }, { 40.f, 10.f }, { 40.f, 40.f } };
+	constexpr std::size_t kMiterPixels = 33*6 + 6*27;
+
+	StrokeStyle style;
+	style.width = 6.f;
+
+	SECTION( "miter" )
+	{
+		style.join = ELineJoin::miter;
+		REQUIRE( kMiterPixels == draw_stroke_( surface, corner, style ) );
+		REQUIRE( kMiterPixels == count_lit_pixels( surface ) );
+	}
+
+	SECTION( "miter limit" )
+	{
+		// A right angle has a miter ratio of sqrt(2)
+		style.join = ELineJoin::miter;
+		style.miterLimit = 1.2f;
+
+		auto const written = draw_stroke_( surface, corner, style );
+		REQUIRE( written < kMiterPixels );
+		REQUIRE( written == count_lit_pixels( surface ) );
+	}
+
+	SECTION( "bevel and round" )
+	{
+		style.join = ELineJoin::bevel;
+		auto const bevel = draw_stroke_( surface, corner, style );
+
+		surface.clear();
+		style.join = ELineJoin::round;
+		auto const round = draw_stroke_( surface, corner, style );
+
+		REQUIRE( bevel < round );
+		REQUIRE( round < kMiterPixels );
+		REQUIRE( round == count_lit_pixels( surface ) );
+	}
+}
+
+TEST_CASE( "Stroke without overdraw", "[stroke]" )
+{
+	Surface surface( 128, 128 );
+	surface.clear();
+
+	// Zig-zag with sharp turns, where the segments and joins overlap a lot.
+	std::vector<Vec2f> const zigzag{ 
+		{ 10.f, 10.f }, { 110.f, 20.f }, { 15.f, 30.f }, 
+		{ 100.f, 60.f }, { 20.f, 64.f }, { 64.f, 120.f } 
+	};
+
+	auto const join = GENERATE( ELineJoin::miter, ELineJoin::bevel, ELineJoin::round );
+
+	StrokeStyle style;
+	style.width = 9.f;
+	style.join = join;
+	style.cap = ELineCap::square;
+
+	auto const written = draw_stroke_( surface, zigzag, style );
+	REQUIRE( written > 0 );
+	REQUIRE( written == count_lit_pixels( surface ) );
+}
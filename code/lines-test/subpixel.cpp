@@ -0,0 +1,89 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <random>
+
+#include <cstring>
+
+#include "helpers.hpp"
+
+#include "../draw2d/surface.hpp"
+#include "../draw2d/draw.hpp"
+
+
+TEST_CASE( "Sub-pixel end points", "[subpixel]" )
+{
+	Surface surface( 64, 64 );
+	surface.clear();
+
+	// Pixel (x,y) covers [x,x+1) x [y,y+1); end points are not truncated
+	// towards zero.
+	SECTION( "negative coordinates" )
+	{
+		draw_line_solid( surface,
+			{ -0.25f, 3.5f },
+			{ -0.25f, 40.5f },
+			{ 255, 255, 255 }
+		);
+
+		REQUIRE( 0 == max_col_pixel_count( surface ) );
+	}
+
+	SECTION( "fractional columns" )
+	{
+		draw_line_solid( surface,
+			{ 0.6f, 2.2f },
+			{ 9.6f, 2.2f },
+			{ 255, 255, 255 }
+		);
+
+		REQUIRE( 10 == max_row_pixel_count( surface ) );
+		REQUIRE( 1 == max_col_pixel_count( surface ) );
+	}
+
+	SECTION( "sampled at pixel centers" )
+	{
+		// The line is sampled at x = 10.5, 11.5, ..., 14.5, where y is
+		// 20.125, 20.375, ..., 21.125.
+		draw_line_solid( surface,
+			{ 10.f, 20.f },
+			{ 14.f, 21.f },
+			{ 255, 255, 255 }
+		);
+
+		auto const* ptr = surface.get_surface_ptr();
+		auto const at = [&] (int aX, int aY) {
+			return 0 != ptr[surface.get_linear_index( aX, aY )];
+		};
+
+		REQUIRE( at( 10, 20 ) );
+		REQUIRE( at( 11, 20 ) );
+		REQUIRE( at( 12, 20 ) );
+		REQUIRE( at( 13, 20 ) );
+		REQUIRE( at( 14, 21 ) );
+		REQUIRE( 4 == max_row_pixel_count( surface ) );
+	}
+}
+
+TEST_CASE( "Reversed lines match", "[subpixel]" )
+{
+	// Drawing a line from A to B must produce the same pixels as drawing it
+	// from B to A, also for fractional and negative end points.
+	std::minstd_rand rng( 1 );
+	std::uniform_real_distribution<float> dist( -20.f, 84.f );
+
+	Surface forward( 64, 64 ), backward( 64, 64 );
+
+	for( int i = 0; i < 200; ++i )
+	{
+		Vec2f const a{ dist( rng ), dist( rng ) };
+		Vec2f const b{ dist( rng ), dist( rng ) };
+
+		forward.clear();
+		draw_line_solid( forward, a, b, { 255, 255, 255 } );
+
+		backward.clear();
+		draw_line_solid( backward, b, a, { 255, 255, 255 } );
+
+		REQUIRE( 0 == std::memcmp( forward.get_surface_ptr(), backward.get_surface_ptr(), forward.get_pitch()*64 ) );
+	}
+}
@@ -6,6 +6,7 @@
 #include <cassert>
 
 #include "../draw2d/shape.hpp"
+#include "../draw2d/surface.hpp"
 
 #include "asteroid.hpp"
 
@@ -149,22 +150,40 @@ void AsteroidField::draw( Surface& aSurface ) const
 	auto const numAsteroids = mAsteroids.size();
 	assert( numAsteroids == mShapes.size() );
 
+	// Asteroids in the padding around the visible region are rejected as a
+	// whole, before any of their vertices are transformed (see fan_stats()).
+	PixelRect const visible{ 0, 0, int(aSurface.get_width()), int(aSurface.get_height()) };
+
 	for( std::size_t i = 0; i < numAsteroids; ++i )
 	{
 		auto const& astr = mAsteroids[i];
 		auto const& shape = mShapes[i];
 
-		// Performance: culling asteroids here would remove some work; right
-		// now each triangle will be culled individually.
-
 		shape.draw(
 			aSurface,
 			astr.rot,
-			astr.pos
+			astr.pos,
+			visible
 		);
 	}
 }
 
+void AsteroidField::draw( TriangleBinner& aBinner ) const
+{
+	auto const numAsteroids = mAsteroids.size();
+	assert( numAsteroids == mShapes.size() );
+
+	// As above, asteroids in the padding are rejected before they are
+	// transformed and binned.
+	PixelRect const visible{ 0, 0, int(mExactExtent.x), int(mExactExtent.y) };
+
+	for( std::size_t i = 0; i < numAsteroids; ++i )
+	{
+		auto const& astr = mAsteroids[i];
+		mShapes[i].draw( aBinner, astr.rot, astr.pos, visible );
+	}
+}
+
 void AsteroidField::resize( std::uint32_t aWidth, std::uint32_t aHeight )
 {
 	// WARNING: This is a bit of a hack...
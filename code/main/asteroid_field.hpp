@@ -50,6 +50,10 @@ class AsteroidField
 
 		void draw( Surface& ) const;
 
+		// Submits the asteroids to the binner; they are drawn when the
+		// binner is flushed.
+		void draw( TriangleBinner& ) const;
+
 		void resize( std::uint32_t aWidth, std::uint32_t aHeight );
 
 	private:
@@ -11,6 +11,7 @@
 #include "../draw2d/surface.hpp"
 #include "../draw2d/draw.hpp"
 #include "../draw2d/shape.hpp"
+#include "../draw2d/binner.hpp"
 
 #include "../support/error.hpp"
 #include "../support/context.hpp"
@@ -147,8 +148,13 @@ int main( int aArgc, char* aArgv[] ) try
 	auto fbheight = std::uint32_t(iheight / hscale) >> config.framebufferScaleShift;
 
 	Context context( fbwidth, fbheight );
+
+	set_surface_huge_pages( config.hugePages );
 	Surface surface( fbwidth, fbheight );
 
+	// Asteroids are rasterized in screen tiles, on all hardware threads
+	TriangleBinner binner;
+
 	glViewport( 0, 0, iwidth, iheight );
 
 	// Resources
@@ -163,6 +169,12 @@ int main( int aArgc, char* aArgv[] ) try
 	// Main loop
 	auto lastUpdateTime = Clock::now();
 
+	// Bytes cleared and uploaded per frame, averaged over a few seconds. Only
+	// the parts of the surface that changed are cleared and uploaded (see
+	// Surface::clear() and Context::draw()).
+	auto lastReportTime = lastUpdateTime;
+	std::size_t reportFrames = 0, reportCleared = 0, reportUploaded = 0;
+
 	while( !glfwWindowShouldClose( window ) )
 	{
 		// Let GLFW process events
@@ -203,7 +215,7 @@ int main( int aArgc, char* aArgv[] ) try
 				// Resize things
 				context.resize( fbwidth, fbheight );
 
-				surface = Surface( fbwidth, fbheight );
+				surface.resize( fbwidth, fbheight );
 				background.resize( fbwidth, fbheight );
 				asteroids.resize( fbwidth, fbheight );
 			}
@@ -221,15 +233,32 @@ int main( int aArgc, char* aArgv[] ) try
 	
 		// Draw scene
 		surface.clear();
+		reportCleared += surface.get_cleared_bytes();
 
 		background.draw( surface );
-		asteroids.draw( surface );
+		asteroids.draw( binner );
+		binner.flush( surface );
 
 		auto const rot = make_rotation_2d( state.player.angle );
 		auto const offs = Vec2f{ fbwidth*0.5f, fbheight*0.5f };
 		spaceship.draw( surface, { 0.2f, 0.4f, 0.7f }, rot, offs );
 
-		context.draw( surface );
+		reportUploaded += context.draw( surface );
+		surface.clear_dirty();
+
+		++reportFrames;
+		if( now - lastReportTime >= std::chrono::seconds( 5 ) )
+		{
+			auto const full = double(fbwidth) * fbheight * 4;
+			std::printf( "per frame: %.0f KiB cleared (%.0f%%), %.0f KiB uploaded (%.0f%%); %s storage\n",
+				double(reportCleared) / reportFrames / 1024.0, 100.0 * reportCleared / reportFrames / full,
+				double(reportUploaded) / reportFrames / 1024.0, 100.0 * reportUploaded / reportFrames / full,
+				to_string( surface.get_storage() )
+			);
+
+			lastReportTime = now;
+			reportFrames = reportCleared = reportUploaded = 0;
+		}
 
 		// Display results
 		glfwSwapBuffers( window );
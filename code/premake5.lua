@@ -17,7 +17,7 @@ workspace "COMP3811-cw1"
 	-- Default toolset options
 	filter "toolset:gcc or toolset:clang"
 		linkoptions { "-pthread" }
-		buildoptions { "-march=native", "-Wall", "-pthread" }
+		buildoptions { "-Wall", "-pthread" }
 
 		-- Varriable-length arrays (VLAs) are an extension that GCC and clang
 		-- have long supported. However, they are not part of the C++ standard.
@@ -105,6 +105,9 @@ project "draw2d"
 
 	files( sources )
 
+	-- SIMD kernels are not compiled with instruction set flags; instead, each
+	-- kernel function is marked for its instruction set (see draw2d/cpu.hpp).
+
 project "support"
 	local sources = { 
 		"support/checkpoint.cpp",
@@ -219,7 +222,9 @@ project "triangles-test"
 
 	links "vmlib"
 	links "draw2d"
+	links "support"
 
+	links "x-stb"
 	links "x-catch2"
 
 project "blit-benchmark"
@@ -260,4 +265,22 @@ project "lines-benchmark"
 
 	links "x-benchmark"
 
+project "triangles-benchmark"
+	local sources = { 
+		"triangles-benchmark/**.cpp",
+		"triangles-benchmark/**.hpp",
+		"triangles-benchmark/**.hxx",
+		"triangles-benchmark/**.inl"
+	}
+
+	kind "ConsoleApp"
+	location "triangles-benchmark"
+
+	files( sources )
+
+	links "vmlib"
+	links "draw2d"
+
+	links "x-benchmark"
+
 --EOF
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include <cstdio>
+#include <cassert>
 
 #include <glad.h>
 #include <GLFW/glfw3.h>
@@ -78,6 +79,7 @@ namespace
 Context::Context( std::size_t aWidth, std::size_t aHeight )
 	: mTexImage( 0 )
 	, mWidth( 0 ), mHeight( 0 )
+	, mFullUpload( true )
 	, mVAO( 0 )
 	, mProgram( 0 )
 {
@@ -104,7 +106,7 @@ Context::~Context()
 }
 
 
-void Context::draw( Surface const& aSurface )
+std::size_t Context::draw( Surface const& aSurface )
 {
 	OGL_CHECKPOINT_DEBUG();
 
@@ -112,14 +114,40 @@ void Context::draw( Surface const& aSurface )
 	glActiveTexture( GL_TEXTURE0 );
 	glBindTexture( GL_TEXTURE_2D, mTexImage );
 
+	// The surface's rows are padded (see Surface::get_pitch()); the row
+	// length is given in pixels.
 	glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
-	glTexSubImage2D( GL_TEXTURE_2D,
-		0,
-		0, 0,
-		GLsizei(mWidth), GLsizei(mHeight),
-		GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV,
-		aSurface.get_surface_ptr()
-	);
+	glPixelStorei( GL_UNPACK_ROW_LENGTH, GLint(aSurface.get_pitch() / 4) );
+
+	std::size_t uploaded = 0;
+	auto const upload = [&] (PixelRect const& aRect) {
+		auto const width = aRect.x1 - aRect.x0, height = aRect.y1 - aRect.y0;
+		glTexSubImage2D( GL_TEXTURE_2D,
+			0,
+			aRect.x0, aRect.y0,
+			GLsizei(width), GLsizei(height),
+			GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV,
+			aSurface.get_surface_ptr() + aSurface.get_linear_index( Surface::Index(aRect.x0), Surface::Index(aRect.y0) )
+		);
+		uploaded += std::size_t(width) * std::size_t(height) * 4;
+	};
+
+	assert( aSurface.get_width() == mWidth && aSurface.get_height() == mHeight );
+	if( mFullUpload )
+	{
+		upload( PixelRect{ 0, 0, int(mWidth), int(mHeight) } );
+		mFullUpload = false;
+	}
+	else
+	{
+		mDirtyRects.clear();
+		aSurface.get_dirty_rects( mDirtyRects );
+
+		for( auto const& rect : mDirtyRects )
+			upload( rect );
+	}
+
+	glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
 	OGL_CHECKPOINT_DEBUG();
 
 	// Draw stuff
@@ -134,6 +162,8 @@ void Context::draw( Surface const& aSurface )
 	glBindTexture( GL_TEXTURE_2D, 0 );
 	
 	OGL_CHECKPOINT_DEBUG();
+
+	return uploaded;
 }
 
 void Context::resize( std::size_t aWidth, std::size_t aHeight )
@@ -149,6 +179,7 @@ void Context::resize( std::size_t aWidth, std::size_t aHeight )
 		mTexImage = tex;
 		mWidth = aWidth;
 		mHeight = aHeight;
+		mFullUpload = true;
 	}
 }
 
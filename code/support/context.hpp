@@ -3,9 +3,12 @@
 
 #include <glad.h>
 
+#include <vector>
+
 #include <cstdint>
 #include <cstdlib>
 
+#include "../draw2d/draw.hpp"
 #include "../draw2d/forward.hpp"
 
 class Context final
@@ -21,7 +24,12 @@ class Context final
 		Context& operator= (Context&&) noexcept;
 
 	public:
-		void draw( Surface const& );
+		// Upload the surface and draw it. Only the surface's dirty tiles
+		// are uploaded (see Surface::get_dirty_rects()), except for the
+		// first upload after the texture was (re-)created. The caller
+		// decides when to forget the dirty tiles (Surface::clear_dirty()).
+		// Returns the number of bytes uploaded.
+		std::size_t draw( Surface const& );
 
 		void resize( std::size_t aWidth, std::size_t aHeight );
 
@@ -42,6 +50,9 @@ class Context final
 		// Surface texture
 		GLuint mTexImage;
 		std::size_t mWidth, mHeight;
+
+		bool mFullUpload; // texture contents are undefined
+		std::vector<PixelRect> mDirtyRects;
 		
 		// Drawing
 		// We need an empty VAO for attribute-less rendering. Drawing with the
@@ -27,6 +27,10 @@ RuntimeConfig parse_command_line( int aArgc, char const* const* aArgv )
 				synopsis_( aArgv[0] );
 				std::exit( 0 );
 			}
+			else if( 0 == std::strcmp( "hugepages", name ) )
+			{
+				config.hugePages = true;
+			}
 			else
 			{
 				throw Error( "Error while parsing command line\n" 
@@ -88,6 +92,7 @@ namespace
 
 Where <flag> may be one off the following
   help         : print this help and exit successfully
+  hugepages    : back large framebuffers by huge pages, if available
 
 and where <option> and <value> may be the following
   geometry    <width>x<height>    set initial window size to (width, height)
@@ -13,6 +13,8 @@ struct RuntimeConfig
 	unsigned initialWindowHeight = cfg::kInitialWindowHeight;
 
 	unsigned framebufferScaleShift = 0;
+
+	bool hugePages = false; // back large surfaces by huge pages, if possible
 };
 
 RuntimeConfig parse_command_line( int aArgc, char const* const* aArgv );
@@ -0,0 +1,744 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include <cmath>
+
+#include "../draw2d/cpu.hpp"
+#include "../draw2d/shape.hpp"
+#include "../draw2d/binner.hpp"
+#include "../draw2d/color.hpp"
+#include "../draw2d/draw.hpp"
+#include "../draw2d/surface.hpp"
+
+namespace
+{
+	// Triangles of roughly aSize x aSize pixels at random positions on a
+	// 1920x1080 surface. The count is chosen such that each iteration covers
+	// about one screen's worth of pixels (at least one triangle). The
+	// triangles are not axis-aligned and their vertices are not at pixel
+	// corners.
+	struct TriangleSet_
+	{
+		std::vector<Vec2f> vertices;
+		double pixels = 0.0; // total area
+	};
+
+	constexpr std::uint32_t kWidth = 1920;
+	constexpr std::uint32_t kHeight = 1080;
+
+	TriangleSet_ make_triangles_(float aSize)
+	{
+		auto const area = 0.44f * aSize * aSize;
+		auto const count = std::max(std::size_t(1), std::size_t(float(kWidth*kHeight) / area));
+
+		std::minstd_rand rng(12345);
+		std::uniform_real_distribution<float> xdist(0.f, std::max(0.f, float(kWidth) - aSize));
+		std::uniform_real_distribution<float> ydist(0.f, std::max(0.f, float(kHeight) - aSize));
+
+		TriangleSet_ ret;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			Vec2f const base{ xdist(rng), ydist(rng) };
+			ret.vertices.emplace_back(base);
+			ret.vertices.emplace_back(base + Vec2f{ aSize, 0.3f*aSize });
+			ret.vertices.emplace_back(base + Vec2f{ 0.4f*aSize, aSize });
+		}
+
+		ret.pixels = double(count) * area;
+		return ret;
+	}
+
+	enum class ETriangleMode_
+	{
+		solid,
+		interp,
+		interpScalar, // interp, with SIMD disabled
+		interpUniform // interp, all vertices with the same color
+	};
+
+	void draw_(Surface& aSurface, Vec2f aP0, Vec2f aP1, Vec2f aP2, ETriangleMode_ aMode)
+	{
+		if (ETriangleMode_::interpUniform == aMode)
+		{
+			ColorF const color{ 1.f, 1.f, 1.f };
+			draw_triangle_interp(aSurface, aP0, aP1, aP2, color, color, color);
+		}
+		else if (ETriangleMode_::solid != aMode)
+		{
+			draw_triangle_interp(aSurface, aP0, aP1, aP2,
+				{ 1.f, 0.f, 0.f },
+				{ 0.f, 1.f, 0.f },
+				{ 0.f, 0.f, 1.f }
+			);
+		}
+		else
+		{
+			draw_triangle_solid(aSurface, aP0, aP1, aP2, { 255, 255, 255 });
+		}
+	}
+
+	// Random triangles with a size of aState.range(0) pixels. Reports the
+	// number of pixels drawn per second.
+	void a_triangle_size_(benchmark::State& aState, ETriangleMode_ aMode)
+	{
+		auto const tris = make_triangles_(float(aState.range(0)));
+
+		Surface surface(kWidth, kHeight);
+		surface.clear();
+
+		if (ETriangleMode_::interpScalar == aMode)
+			set_simd_level_limit(ESimdLevel::scalar);
+
+		for (auto _ : aState)
+		{
+			auto const& v = tris.vertices;
+			for (std::size_t i = 0; i+2 < v.size(); i += 3)
+				draw_(surface, v[i], v[i+1], v[i+2], aMode);
+
+			benchmark::ClobberMemory();
+		}
+
+		set_simd_level_limit(ESimdLevel::avx2);
+
+		aState.counters["pixels"] = benchmark::Counter(
+			tris.pixels,
+			benchmark::Counter::kIsIterationInvariantRate
+		);
+	}
+
+	// Two triangles covering the whole surface
+	void b_fullscreen_(benchmark::State& aState, ETriangleMode_ aMode)
+	{
+		Surface surface(kWidth, kHeight);
+		surface.clear();
+
+		Vec2f const p00{ 0.f, 0.f }, p10{ float(kWidth), 0.f };
+		Vec2f const p01{ 0.f, float(kHeight) }, p11{ float(kWidth), float(kHeight) };
+
+		if (ETriangleMode_::interpScalar == aMode)
+			set_simd_level_limit(ESimdLevel::scalar);
+
+		for (auto _ : aState)
+		{
+			draw_(surface, p00, p10, p11, aMode);
+			draw_(surface, p00, p11, p01, aMode);
+
+			benchmark::ClobberMemory();
+		}
+
+		set_simd_level_limit(ESimdLevel::avx2);
+
+		aState.counters["pixels"] = benchmark::Counter(
+			double(kWidth) * kHeight,
+			benchmark::Counter::kIsIterationInvariantRate
+		);
+	}
+
+	// Conversion of a 1920x1080 image (one color per pixel) from linear RGB
+	// to sRGB. The FAST and FASTER methods are reproduced here, since only
+	// the configured DRAW2D_CFG_SRGB_MODE is compiled into the library.
+	enum class ESrgbMode_
+	{
+		exact,
+		fast,
+		faster,
+		configured,
+		configuredBatch,
+		lut12
+	};
+
+	void c_linear_to_srgb_(benchmark::State& aState, ESrgbMode_ aMode)
+	{
+		std::size_t const count = std::size_t(kWidth) * kHeight;
+
+		std::minstd_rand rng(12345);
+		std::uniform_real_distribution<float> dist(0.f, 1.f);
+
+		std::vector<ColorF> colors(count);
+		for (auto& col : colors)
+			col = ColorF{ dist(rng), dist(rng), dist(rng) };
+
+		std::vector<ColorU8_sRGB> out(count);
+
+		auto const convert = [&](auto&& aFn) {
+			for (std::size_t i = 0; i < count; ++i)
+				out[i] = ColorU8_sRGB{ aFn(colors[i].r), aFn(colors[i].g), aFn(colors[i].b) };
+		};
+
+		for (auto _ : aState)
+		{
+			switch (aMode)
+			{
+				case ESrgbMode_::exact:
+					convert([](float aValue) { return linear_to_srgb_exact(aValue); });
+					break;
+				case ESrgbMode_::fast:
+					convert([](float aValue) { return std::uint8_t(255.f * std::pow(aValue, 1.f/2.4f) + 0.5f); });
+					break;
+				case ESrgbMode_::faster:
+					convert([](float aValue) { return std::uint8_t(255.f * std::sqrt(aValue) + 0.5f); });
+					break;
+				case ESrgbMode_::configured:
+					convert([](float aValue) { return linear_to_srgb(aValue); });
+					break;
+				case ESrgbMode_::configuredBatch:
+					linear_to_srgb(count, colors.data(), out.data());
+					break;
+				case ESrgbMode_::lut12:
+					convert([](float aValue) { return linear_to_srgb_lut(aValue); });
+					break;
+			}
+
+			benchmark::DoNotOptimize(out.data());
+			benchmark::ClobberMemory();
+		}
+
+		aState.counters["pixels"] = benchmark::Counter(
+			double(count),
+			benchmark::Counter::kIsIterationInvariantRate
+		);
+	}
+
+	// Asteroid-like field: aCount fans of 18 triangles, each about 60 px
+	// across, scattered over a 3840x2160 (4K) surface. Drawn either directly
+	// (as triangles or scanned, see EFanMode) or through a TriangleBinner
+	// with aState.range(0) threads.
+	std::vector<TriangleFan> make_fans_(std::size_t aCount, std::vector<Vec2f>& aPositions)
+	{
+		constexpr std::size_t kPoints = 18;
+
+		std::minstd_rand rng(12345);
+		std::uniform_real_distribution<float> xdist(0.f, 3840.f);
+		std::uniform_real_distribution<float> ydist(0.f, 2160.f);
+		std::uniform_real_distribution<float> rdist(25.f, 35.f);
+		std::uniform_real_distribution<float> cdist(0.1f, 0.5f);
+
+		std::vector<TriangleFan> fans;
+		for (std::size_t i = 0; i < aCount; ++i)
+		{
+			std::vector<TriangleFan::PosAndCol> verts;
+			verts.emplace_back(TriangleFan::PosAndCol{ { 0.f, 0.f }, { cdist(rng), cdist(rng), cdist(rng) } });
+			for (std::size_t j = 0; j < kPoints; ++j)
+			{
+				float const angle = 6.2831853f * float(j) / kPoints;
+				float const radius = rdist(rng);
+				verts.emplace_back(TriangleFan::PosAndCol{
+					{ radius * std::cos(angle), radius * std::sin(angle) },
+					{ cdist(rng), cdist(rng), cdist(rng) }
+				});
+			}
+
+			fans.emplace_back(verts.size(), verts.data());
+			aPositions.emplace_back(Vec2f{ xdist(rng), ydist(rng) });
+		}
+
+		return fans;
+	}
+
+	void d_asteroids_direct_(benchmark::State& aState, EFanMode aMode)
+	{
+		std::vector<Vec2f> positions;
+		auto const fans = make_fans_(2000, positions);
+
+		Surface surface(3840, 2160);
+		Mat22f const identity{ 1.f, 0.f, 0.f, 1.f };
+
+		for (auto _ : aState)
+		{
+			surface.clear();
+			for (std::size_t i = 0; i < fans.size(); ++i)
+				fans[i].draw(surface, identity, positions[i], aMode);
+
+			benchmark::ClobberMemory();
+		}
+	}
+
+	void d_asteroids_binned_(benchmark::State& aState)
+	{
+		std::vector<Vec2f> positions;
+		auto const fans = make_fans_(2000, positions);
+
+		Surface surface(3840, 2160);
+		Mat22f const identity{ 1.f, 0.f, 0.f, 1.f };
+
+		TriangleBinner binner(std::size_t(aState.range(0)));
+
+		for (auto _ : aState)
+		{
+			surface.clear();
+			for (std::size_t i = 0; i < fans.size(); ++i)
+				fans[i].draw(binner, identity, positions[i]);
+
+			binner.flush(surface);
+			benchmark::ClobberMemory();
+		}
+	}
+
+	// Asteroid field as in main: 1000 fans scattered over a 1920x1080
+	// surface and a padding of 300 px around it. Drawn either without
+	// culling, or with the fan-level culling of TriangleFan::draw() (see
+	// FanStats in shape.hpp). Reports the drawn and culled fans per frame.
+	void g_asteroid_culling_(benchmark::State& aState, bool aCull)
+	{
+		constexpr float kPadding = 300.f;
+
+		std::vector<Vec2f> positions;
+		auto const fans = make_fans_(1000, positions);
+
+		std::minstd_rand rng(321);
+		std::uniform_real_distribution<float> xdist(-kPadding, float(kWidth) + kPadding);
+		std::uniform_real_distribution<float> ydist(-kPadding, float(kHeight) + kPadding);
+		for (auto& pos : positions)
+			pos = Vec2f{ xdist(rng), ydist(rng) };
+
+		Surface surface(kWidth, kHeight);
+		surface.clear();
+
+		Mat22f const rotation = make_rotation_2d(0.3f);
+		PixelRect const visible{ 0, 0, int(kWidth), int(kHeight) };
+
+		reset_fan_stats();
+
+		for (auto _ : aState)
+		{
+			for (std::size_t i = 0; i < fans.size(); ++i)
+			{
+				if (aCull)
+					fans[i].draw(surface, rotation, positions[i], visible);
+				else
+					fans[i].draw(surface, rotation, positions[i]);
+			}
+
+			benchmark::ClobberMemory();
+		}
+
+		auto const stats = fan_stats();
+		aState.counters["drawn"] = benchmark::Counter(double(stats.drawn), benchmark::Counter::kAvgIterations);
+		aState.counters["culled"] = benchmark::Counter(double(stats.culled), benchmark::Counter::kAvgIterations);
+	}
+
+	// Rasterizer efficiency (see RasterStats in draw.hpp) for a few shapes on
+	// a 1920x1080 surface: a sliver along the diagonal, a screen-filling
+	// pair of triangles, and a single triangle covering half the screen.
+	// Reports per iteration: edge tests and pixels written, the fraction of
+	// the bounding boxes that was written, and the band classification.
+	enum class ECoverageShape_
+	{
+		sliver,
+		fullscreen,
+		half
+	};
+
+	void e_coverage_(benchmark::State& aState, ECoverageShape_ aShape)
+	{
+		Surface surface(kWidth, kHeight);
+		surface.clear();
+
+		float const w = float(kWidth), h = float(kHeight);
+
+		std::vector<Vec2f> tris;
+		switch (aShape)
+		{
+			case ECoverageShape_::sliver:
+				tris = { { 0.3f, 0.6f }, { w - 0.2f, h - 2.1f }, { w - 0.7f, h - 0.4f } };
+				break;
+			case ECoverageShape_::fullscreen:
+				tris = { { 0.f, 0.f }, { w, 0.f }, { w, h }, { 0.f, 0.f }, { w, h }, { 0.f, h } };
+				break;
+			case ECoverageShape_::half:
+				tris = { { 0.f, 0.f }, { w, 0.f }, { 0.f, h } };
+				break;
+		}
+
+		reset_raster_stats();
+
+		for (auto _ : aState)
+		{
+			for (std::size_t i = 0; i+2 < tris.size(); i += 3)
+				draw_triangle_solid(surface, tris[i], tris[i+1], tris[i+2], { 255, 255, 255 });
+
+			benchmark::ClobberMemory();
+		}
+
+		auto const stats = raster_stats();
+		auto const per_iteration = [&](std::uint64_t aValue) {
+			return benchmark::Counter(double(aValue), benchmark::Counter::kAvgIterations);
+		};
+
+		aState.counters["edge_tests"] = per_iteration(stats.edgeTests);
+		aState.counters["written"] = per_iteration(stats.pixelsWritten);
+		aState.counters["bounds_fill"] = double(stats.pixelsWritten) / double(stats.boundsPixels);
+		aState.counters["bands_out"] = per_iteration(stats.bandsOutside);
+		aState.counters["bands_in"] = per_iteration(stats.bandsInside);
+		aState.counters["bands_partial"] = per_iteration(stats.bandsPartial);
+		aState.counters["pixels"] = benchmark::Counter(
+			double(stats.pixelsWritten),
+			benchmark::Counter::kIsRate
+		);
+	}
+
+	// A regular grid mesh of aState.range(0) pixel cells over a 1920x1080
+	// surface, two triangles per cell, with per-vertex colors. Most
+	// vertices are shared by six triangles. The mesh is drawn either one
+	// triangle at a time (transforming each triangle's vertices) or as a
+	// single indexed batch.
+	enum class EMeshMode_
+	{
+		individual,
+		indexed
+	};
+
+	void f_mesh_(benchmark::State& aState, EMeshMode_ aMode)
+	{
+		auto const cell = float(aState.range(0));
+		auto const columns = std::uint32_t(float(kWidth) / cell);
+		auto const rows = std::uint32_t(float(kHeight) / cell);
+
+		std::minstd_rand rng(4321);
+		std::uniform_real_distribution<float> jitter(-0.25f * cell, 0.25f * cell);
+		std::uniform_real_distribution<float> cdist(0.f, 1.f);
+
+		std::vector<Vec2f> positions;
+		std::vector<ColorF> colors;
+		for (std::uint32_t y = 0; y <= rows; ++y)
+		{
+			for (std::uint32_t x = 0; x <= columns; ++x)
+			{
+				positions.emplace_back(Vec2f{ float(x) * cell + jitter(rng), float(y) * cell + jitter(rng) });
+				colors.emplace_back(ColorF{ cdist(rng), cdist(rng), cdist(rng) });
+			}
+		}
+
+		std::vector<std::uint32_t> indices;
+		for (std::uint32_t y = 0; y < rows; ++y)
+		{
+			for (std::uint32_t x = 0; x < columns; ++x)
+			{
+				std::uint32_t const i = y * (columns+1) + x;
+				std::uint32_t const quad[6] = { i, i+1, i+columns+2, i, i+columns+2, i+columns+1 };
+				indices.insert(indices.end(), quad, quad+6);
+			}
+		}
+
+		Surface surface(kWidth, kHeight);
+		surface.clear();
+
+		Mat22f const transform = make_rotation_2d(0.01f);
+		Vec2f const translation{ 0.5f, 0.25f };
+		std::size_t const triangles = indices.size() / 3;
+
+		for (auto _ : aState)
+		{
+			if (EMeshMode_::indexed == aMode)
+			{
+				draw_triangles_interp(surface, positions.size(), positions.data(), colors.data(), triangles, indices.data(), transform, translation);
+			}
+			else
+			{
+				for (std::size_t i = 0; i < triangles; ++i)
+				{
+					auto const* idx = indices.data() + 3*i;
+					draw_triangle_interp(surface,
+						transform * positions[idx[0]] + translation,
+						transform * positions[idx[1]] + translation,
+						transform * positions[idx[2]] + translation,
+						colors[idx[0]], colors[idx[1]], colors[idx[2]]
+					);
+				}
+			}
+
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed(std::int64_t(triangles) * aState.iterations());
+	}
+
+	// Rectangles of aState.range(0) x aState.range(1) pixels on a 7680x4320
+	// surface, at random (pixel-aligned) positions. As with
+	// a_triangle_size_, each iteration covers about 1920x1080 pixels (at
+	// least one rectangle). The rectangles are either filled, filled as two
+	// triangles, filled with SIMD disabled, or outlined.
+	enum class ERectangleMode_
+	{
+		solid,
+		solidScalar,
+		triangles,
+		outline
+	};
+
+	void h_rectangle_(benchmark::State& aState, ERectangleMode_ aMode)
+	{
+		constexpr std::uint32_t kRectWidth = 7680;
+		constexpr std::uint32_t kRectHeight = 4320;
+
+		auto const w = float(aState.range(0));
+		auto const h = float(aState.range(1));
+		auto const count = std::max(std::size_t(1), std::size_t(float(kWidth) * float(kHeight) / (w * h)));
+
+		std::minstd_rand rng(777);
+		std::uniform_int_distribution<int> xdist(0, int(kRectWidth - std::uint32_t(w)));
+		std::uniform_int_distribution<int> ydist(0, int(kRectHeight - std::uint32_t(h)));
+
+		std::vector<Vec2f> corners;
+		for (std::size_t i = 0; i < count; ++i)
+			corners.emplace_back(Vec2f{ float(xdist(rng)), float(ydist(rng)) });
+
+		Surface surface(kRectWidth, kRectHeight);
+		surface.clear();
+
+		if (ERectangleMode_::solidScalar == aMode)
+			set_simd_level_limit(ESimdLevel::scalar);
+
+		ColorU8_sRGB const color{ 255, 255, 255 };
+		for (auto _ : aState)
+		{
+			for (auto const& c : corners)
+			{
+				Vec2f const d = c + Vec2f{ w, h };
+				if (ERectangleMode_::outline == aMode)
+				{
+					draw_rectangle_outline(surface, c, d, color);
+				}
+				else if (ERectangleMode_::triangles == aMode)
+				{
+					draw_triangle_solid(surface, c, Vec2f{ d.x, c.y }, d, color);
+					draw_triangle_solid(surface, c, d, Vec2f{ c.x, d.y }, color);
+				}
+				else
+				{
+					draw_rectangle_solid(surface, c, d, color);
+				}
+			}
+
+			benchmark::ClobberMemory();
+		}
+
+		set_simd_level_limit(ESimdLevel::avx2);
+
+		auto const pixels = ERectangleMode_::outline == aMode
+			? double(count) * 2.0 * (w + h)
+			: double(count) * w * h
+		;
+		aState.counters["pixels"] = benchmark::Counter(
+			pixels,
+			benchmark::Counter::kIsIterationInvariantRate
+		);
+		aState.SetBytesProcessed(std::int64_t(pixels * 4.0) * aState.iterations());
+	}
+
+	// Pixel writes: the same spans (from a simple scanline loop over the
+	// triangles of a_triangle_size_), written either one pixel at a time
+	// with Surface::set_pixel_srgb(), or with Surface::write_span(). The
+	// rasterizer itself (draw_triangle_solid()) is included for reference.
+	enum class EWriteMode_
+	{
+		perPixel,
+		span,
+		rasterizer
+	};
+
+	template <typename tSpanFn>
+	void scan_triangle_(Vec2f aP0, Vec2f aP1, Vec2f aP2, int aWidth, int aHeight, tSpanFn&& aSpanFn)
+	{
+		Vec2f const p[3] = { aP0, aP1, aP2 };
+
+		float const minY = std::min({ aP0.y, aP1.y, aP2.y });
+		float const maxY = std::max({ aP0.y, aP1.y, aP2.y });
+
+		int const y0 = std::max(0, int(std::ceil(minY - 0.5f)));
+		int const y1 = std::min(aHeight, int(std::ceil(maxY - 0.5f)));
+		for (int y = y0; y < y1; ++y)
+		{
+			float const yc = float(y) + 0.5f;
+			float left = float(aWidth), right = 0.f;
+			for (int e = 0; e < 3; ++e)
+			{
+				Vec2f const a = p[e], b = p[(e+1) % 3];
+				if ((yc < a.y) == (yc < b.y))
+					continue;
+
+				float const x = a.x + (yc - a.y) * (b.x - a.x) / (b.y - a.y);
+				left = std::min(left, x);
+				right = std::max(right, x);
+			}
+
+			int const x0 = std::max(0, int(std::ceil(left - 0.5f)));
+			int const x1 = std::min(aWidth, int(std::ceil(right - 0.5f)));
+			if (x0 < x1)
+				aSpanFn(y, x0, x1);
+		}
+	}
+
+	void i_pixel_writes_(benchmark::State& aState, EWriteMode_ aMode)
+	{
+		auto const tris = make_triangles_(float(aState.range(0)));
+
+		Surface surface(kWidth, kHeight);
+		surface.clear();
+
+		ColorU8_sRGB const color{ 255, 128, 0 };
+		for (auto _ : aState)
+		{
+			auto const& v = tris.vertices;
+			for (std::size_t i = 0; i+2 < v.size(); i += 3)
+			{
+				if (EWriteMode_::rasterizer == aMode)
+				{
+					draw_triangle_solid(surface, v[i], v[i+1], v[i+2], color);
+				}
+				else if (EWriteMode_::span == aMode)
+				{
+					auto const pixel = pack_rgbx(color);
+					scan_triangle_(v[i], v[i+1], v[i+2], int(kWidth), int(kHeight), [&] (int aY, int aX0, int aX1) {
+						surface.write_span(Surface::Index(aY), Surface::Index(aX0), Surface::Index(aX1), pixel);
+					});
+				}
+				else
+				{
+					scan_triangle_(v[i], v[i+1], v[i+2], int(kWidth), int(kHeight), [&] (int aY, int aX0, int aX1) {
+						for (int x = aX0; x < aX1; ++x)
+							surface.set_pixel_srgb(Surface::Index(x), Surface::Index(aY), color);
+					});
+				}
+			}
+
+			benchmark::ClobberMemory();
+		}
+
+		aState.counters["pixels"] = benchmark::Counter(
+			tris.pixels,
+			benchmark::Counter::kIsIterationInvariantRate
+		);
+	}
+}
+
+BENCHMARK_CAPTURE(a_triangle_size_, solid, ETriangleMode_::solid)
+	->Arg(8)
+	->Arg(32)
+	->Arg(128)
+	->Arg(512)
+	->Arg(1024)
+;
+BENCHMARK_CAPTURE(a_triangle_size_, interp, ETriangleMode_::interp)
+	->Arg(8)
+	->Arg(32)
+	->Arg(128)
+	->Arg(512)
+	->Arg(1024)
+;
+BENCHMARK_CAPTURE(a_triangle_size_, interp_scalar, ETriangleMode_::interpScalar)
+	->Arg(8)
+	->Arg(32)
+	->Arg(128)
+	->Arg(512)
+	->Arg(1024)
+;
+BENCHMARK_CAPTURE(a_triangle_size_, interp_uniform, ETriangleMode_::interpUniform)
+	->Arg(8)
+	->Arg(32)
+	->Arg(128)
+	->Arg(512)
+	->Arg(1024)
+;
+
+BENCHMARK_CAPTURE(b_fullscreen_, solid, ETriangleMode_::solid);
+BENCHMARK_CAPTURE(b_fullscreen_, interp, ETriangleMode_::interp);
+BENCHMARK_CAPTURE(b_fullscreen_, interp_scalar, ETriangleMode_::interpScalar);
+BENCHMARK_CAPTURE(b_fullscreen_, interp_uniform, ETriangleMode_::interpUniform);
+
+BENCHMARK_CAPTURE(c_linear_to_srgb_, exact, ESrgbMode_::exact);
+BENCHMARK_CAPTURE(c_linear_to_srgb_, fast, ESrgbMode_::fast);
+BENCHMARK_CAPTURE(c_linear_to_srgb_, faster, ESrgbMode_::faster);
+BENCHMARK_CAPTURE(c_linear_to_srgb_, configured, ESrgbMode_::configured);
+BENCHMARK_CAPTURE(c_linear_to_srgb_, configured_batch, ESrgbMode_::configuredBatch);
+BENCHMARK_CAPTURE(c_linear_to_srgb_, lut12, ESrgbMode_::lut12);
+
+BENCHMARK_CAPTURE(e_coverage_, sliver, ECoverageShape_::sliver);
+BENCHMARK_CAPTURE(e_coverage_, fullscreen, ECoverageShape_::fullscreen);
+BENCHMARK_CAPTURE(e_coverage_, half, ECoverageShape_::half);
+
+BENCHMARK_CAPTURE(f_mesh_, individual, EMeshMode_::individual)
+	->Arg(4)
+	->Arg(16)
+	->Arg(64)
+;
+BENCHMARK_CAPTURE(f_mesh_, indexed, EMeshMode_::indexed)
+	->Arg(4)
+	->Arg(16)
+	->Arg(64)
+;
+
+BENCHMARK_CAPTURE(h_rectangle_, solid, ERectangleMode_::solid)
+	->Args({ 4, 4 })
+	->Args({ 32, 32 })
+	->Args({ 256, 256 })
+	->Args({ 1024, 1024 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(h_rectangle_, solid_scalar, ERectangleMode_::solidScalar)
+	->Args({ 4, 4 })
+	->Args({ 32, 32 })
+	->Args({ 256, 256 })
+	->Args({ 1024, 1024 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(h_rectangle_, triangles, ERectangleMode_::triangles)
+	->Args({ 4, 4 })
+	->Args({ 32, 32 })
+	->Args({ 256, 256 })
+	->Args({ 1024, 1024 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+BENCHMARK_CAPTURE(h_rectangle_, outline, ERectangleMode_::outline)
+	->Args({ 4, 4 })
+	->Args({ 32, 32 })
+	->Args({ 256, 256 })
+	->Args({ 1024, 1024 })
+	->Args({ 1920, 1080 })
+	->Args({ 7680, 4320 })
+;
+
+BENCHMARK_CAPTURE(i_pixel_writes_, per_pixel, EWriteMode_::perPixel)
+	->Arg(8)
+	->Arg(32)
+	->Arg(128)
+	->Arg(512)
+;
+BENCHMARK_CAPTURE(i_pixel_writes_, span, EWriteMode_::span)
+	->Arg(8)
+	->Arg(32)
+	->Arg(128)
+	->Arg(512)
+;
+BENCHMARK_CAPTURE(i_pixel_writes_, rasterizer, EWriteMode_::rasterizer)
+	->Arg(8)
+	->Arg(32)
+	->Arg(128)
+	->Arg(512)
+;
+
+BENCHMARK_CAPTURE(g_asteroid_culling_, none, false);
+BENCHMARK_CAPTURE(g_asteroid_culling_, fan, true);
+
+BENCHMARK_CAPTURE(d_asteroids_direct_, triangles, EFanMode::triangles)
+	->Unit(benchmark::kMillisecond)
+;
+BENCHMARK_CAPTURE(d_asteroids_direct_, scan, EFanMode::scan)
+	->Unit(benchmark::kMillisecond)
+;
+BENCHMARK(d_asteroids_binned_)
+	->Arg(1)
+	->Arg(2)
+	->Arg(4)
+	->Arg(8)
+	->Arg(16)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime()
+;
+
+BENCHMARK_MAIN();
@@ -1,10 +1,22 @@
 #include <catch2/catch_amalgamated.hpp>
 
+#include <vector>
+
+#include <cmath>
+#include <cstdint>
+
 #include "helpers.hpp"
 
 #include "../draw2d/surface.hpp"
 #include "../draw2d/draw.hpp"
 
+namespace
+{
+    // Draws each triangle onto a cleared surface and counts how many times
+    // each pixel was written.
+    std::vector<int> count_writes_( std::vector<Vec2f> const&, bool aInterp );
+}
+
 
 TEST_CASE("Two Adjacent Triangles", "[special][!mayfail]")
 {
@@ -36,4 +48,89 @@ TEST_CASE("Two Adjacent Triangles", "[special][!mayfail]")
     REQUIRE(255 == int(col.r));
     REQUIRE(255 == int(col.g));
     REQUIRE(255 == int(col.b));
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Adjacent triangles do not overlap", "[special]" )
+{
+    auto interp = GENERATE( false, true );
+
+    SECTION( "Quad, both diagonals" )
+    {
+        Vec2f const p0{ 10.3f, 12.7f }, p1{ 80.6f, 15.1f }, p2{ 90.2f, 70.9f }, p3{ 5.5f, 66.4f };
+
+        auto const a = count_writes_( { p0, p1, p2,  p0, p2, p3 }, interp );
+        auto const b = count_writes_( { p0, p1, p3,  p1, p2, p3 }, interp );
+
+        for( std::size_t i = 0; i < a.size(); ++i )
+        {
+            REQUIRE( a[i] <= 1 );
+            REQUIRE( b[i] <= 1 );
+
+            // Both splits cover the same quad, so neither may leave gaps
+            REQUIRE( a[i] == b[i] );
+        }
+    }
+
+    SECTION( "Fan" )
+    {
+        Vec2f const center{ 320.37f, 240.61f };
+        float const radius = 600.f; // extends past the surface
+
+        std::vector<Vec2f> tris;
+        int const segments = 16;
+        for( int i = 0; i < segments; ++i )
+        {
+            float const a0 = 6.2831853f * float(i) / segments;
+            float const a1 = 6.2831853f * float((i+1) % segments) / segments;
+
+            tris.emplace_back( center );
+            tris.emplace_back( center + radius * Vec2f{ std::cos( a0 ), std::sin( a0 ) } );
+            tris.emplace_back( center + radius * Vec2f{ std::cos( a1 ), std::sin( a1 ) } );
+        }
+
+        // The polygon covers the whole surface, so each pixel is written
+        // exactly once.
+        auto const counts = count_writes_( tris, interp );
+        for( auto const count : counts )
+            REQUIRE( 1 == count );
+    }
+}
+
+
+namespace
+{
+    std::vector<int> count_writes_( std::vector<Vec2f> const& aTriangles, bool aInterp )
+    {
+        Surface surface( 640, 480 );
+        std::vector<int> counts( surface.get_pitch()/4 * surface.get_height(), 0 );
+
+        for( std::size_t i = 0; i+2 < aTriangles.size(); i += 3 )
+        {
+            surface.fill( { 0, 0, 0 } );
+
+            if( aInterp )
+            {
+                draw_triangle_interp( surface,
+                    aTriangles[i], aTriangles[i+1], aTriangles[i+2],
+                    { 1.f, 1.f, 1.f }, { 1.f, 1.f, 1.f }, { 1.f, 1.f, 1.f }
+                );
+            }
+            else
+            {
+                draw_triangle_solid( surface,
+                    aTriangles[i], aTriangles[i+1], aTriangles[i+2],
+                    { 255, 255, 255 }
+                );
+            }
+
+            auto const* ptr = surface.get_surface_ptr();
+            for( std::size_t j = 0; j < counts.size(); ++j )
+            {
+                if( 0 != ptr[4*j] )
+                    ++counts[j];
+            }
+        }
+
+        return counts;
+    }
+}
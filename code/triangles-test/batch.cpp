@@ -0,0 +1,308 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <random>
+#include <vector>
+
+#include <cmath>
+#include <cstring>
+
+#include "../draw2d/shape.hpp"
+#include "../draw2d/surface.hpp"
+#include "../draw2d/draw.hpp"
+
+
+TEST_CASE( "Indexed triangles match individual triangles", "[batch]" )
+{
+	constexpr std::uint32_t kWidth = 180, kHeight = 120;
+	constexpr std::size_t kVertices = 60, kTriangles = 150;
+
+	// Vertices are shared by several triangles. Some are off screen, and a
+	// few are far outside of the guard band, such that the triangles using
+	// them must be clipped.
+	std::minstd_rand rng( 11 );
+	std::uniform_real_distribution<float> pdist( -40.f, kWidth+40.f );
+	std::uniform_real_distribution<float> cdist( 0.f, 1.f );
+	std::uniform_int_distribution<std::uint32_t> idist( 0, kVertices-1 );
+
+	std::vector<Vec2f> positions( kVertices );
+	std::vector<ColorF> colors( kVertices );
+	for( std::size_t i = 0; i < kVertices; ++i )
+	{
+		float const scale = (i % 17 == 0) ? 1e5f : 1.f;
+		positions[i] = scale * Vec2f{ pdist( rng ), pdist( rng ) * kHeight / kWidth };
+		colors[i] = ColorF{ cdist( rng ), cdist( rng ), cdist( rng ) };
+	}
+
+	std::vector<std::uint32_t> indices( 3*kTriangles );
+	for( auto& index : indices )
+		index = idist( rng );
+
+	// One triangle refers to a vertex that doesn't exist; it is skipped.
+	indices[3*7+1] = kVertices;
+
+	auto const angle = GENERATE( 0.f, 0.3f );
+	Mat22f const transform = make_rotation_2d( angle );
+	Vec2f const translation{ 12.f, -5.f };
+
+	Surface single( kWidth, kHeight );
+	single.clear();
+	for( std::size_t i = 0; i < kTriangles; ++i )
+	{
+		std::uint32_t const* idx = indices.data() + 3*i;
+		if( idx[0] >= kVertices || idx[1] >= kVertices || idx[2] >= kVertices )
+			continue;
+
+		draw_triangle_interp( single,
+			transform * positions[idx[0]] + translation,
+			transform * positions[idx[1]] + translation,
+			transform * positions[idx[2]] + translation,
+			colors[idx[0]], colors[idx[1]], colors[idx[2]]
+		);
+	}
+
+	Surface batched( kWidth, kHeight );
+	batched.clear();
+	draw_triangles_interp( batched, kVertices, positions.data(), colors.data(), kTriangles, indices.data(), transform, translation );
+
+	auto const bytes = std::size_t(single.get_pitch())*kHeight;
+	REQUIRE( 0 == std::memcmp( single.get_surface_ptr(), batched.get_surface_ptr(), bytes ) );
+}
+
+TEST_CASE( "Triangle fans match individual triangles", "[batch]" )
+{
+	auto const mode = GENERATE( EFanMode::triangles, EFanMode::scan );
+
+	constexpr std::uint32_t kWidth = 100, kHeight = 100;
+
+	TriangleFan const fan( {
+		{ { 0.f, 0.f }, { 1.f, 1.f, 1.f } },
+		{ { 30.f, 0.f }, { 1.f, 0.f, 0.f } },
+		{ { 10.f, 25.f }, { 0.f, 1.f, 0.f } },
+		{ { -20.f, 15.f }, { 0.f, 0.f, 1.f } },
+		{ { -25.f, -20.f }, { 1.f, 1.f, 0.f } },
+		{ { 15.f, -30.f }, { 0.f, 1.f, 1.f } }
+	} );
+
+	Mat22f const transform = make_rotation_2d( 1.1f );
+	Vec2f const translation{ 50.f, 48.f };
+
+	// Reference: the fan's triangles, drawn one by one
+	Vec2f const p[6] = {
+		transform * Vec2f{ 0.f, 0.f } + translation,
+		transform * Vec2f{ 30.f, 0.f } + translation,
+		transform * Vec2f{ 10.f, 25.f } + translation,
+		transform * Vec2f{ -20.f, 15.f } + translation,
+		transform * Vec2f{ -25.f, -20.f } + translation,
+		transform * Vec2f{ 15.f, -30.f } + translation
+	};
+	ColorF const c[6] = {
+		{ 1.f, 1.f, 1.f }, { 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f },
+		{ 0.f, 0.f, 1.f }, { 1.f, 1.f, 0.f }, { 0.f, 1.f, 1.f }
+	};
+
+	Surface single( kWidth, kHeight );
+	single.clear();
+	for( int i = 1; i < 6; ++i )
+	{
+		int const j = i < 5 ? i+1 : 1;
+		draw_triangle_interp( single, p[0], p[i], p[j], c[0], c[i], c[j] );
+	}
+
+	Surface batched( kWidth, kHeight );
+	batched.clear();
+	fan.draw( batched, transform, translation, mode );
+
+	auto const bytes = std::size_t(single.get_pitch())*kHeight;
+	REQUIRE( 0 == std::memcmp( single.get_surface_ptr(), batched.get_surface_ptr(), bytes ) );
+}
+
+TEST_CASE( "Scanned fans match individual triangles", "[batch]" )
+{
+	constexpr std::uint32_t kWidth = 160, kHeight = 110;
+	constexpr std::size_t kRim = 18;
+
+	// Random fans: star-shaped ones (like the asteroids), ones that wind
+	// around twice (overlapping triangles, where the order matters), ones
+	// with triangles of both orientations, and ones that are partially off
+	// screen or far outside of the guard band.
+	std::minstd_rand rng( 23 );
+	std::uniform_real_distribution<float> rdist( 2.f, 40.f );
+	std::uniform_real_distribution<float> adist( 0.f, 6.2831853f );
+	std::uniform_real_distribution<float> pdist( -20.f, 180.f );
+	std::uniform_real_distribution<float> cdist( 0.f, 1.f );
+
+	for( int fanIndex = 0; fanIndex < 40; ++fanIndex )
+	{
+		int const kind = fanIndex % 4;
+
+		std::vector<Vec2f> positions( 1+kRim );
+		std::vector<ColorF> colors( 1+kRim );
+
+		positions[0] = Vec2f{ 0.f, 0.f };
+		for( std::size_t i = 0; i < kRim; ++i )
+		{
+			float angle = 6.2831853f * float(i) / kRim;
+			if( 1 == kind )
+				angle *= 2.f;
+			else if( 2 == kind )
+				angle = adist( rng );
+
+			float const radius = 3 == kind && 0 == i ? 1e6f : rdist( rng );
+			positions[1+i] = radius * Vec2f{ std::cos( angle ), std::sin( angle ) };
+		}
+		for( auto& col : colors )
+			col = ColorF{ cdist( rng ), cdist( rng ), cdist( rng ) };
+
+		Mat22f const transform = make_rotation_2d( adist( rng ) );
+		Vec2f const translation{ pdist( rng ), pdist( rng ) * kHeight / kWidth };
+
+		Surface single( kWidth, kHeight );
+		single.clear();
+		for( std::size_t i = 0; i < kRim; ++i )
+		{
+			std::size_t const a = 1+i, b = 1+(i+1) % kRim;
+			draw_triangle_interp( single,
+				transform * positions[0] + translation,
+				transform * positions[a] + translation,
+				transform * positions[b] + translation,
+				colors[0], colors[a], colors[b]
+			);
+		}
+
+		Surface scanned( kWidth, kHeight );
+		scanned.clear();
+		draw_triangle_fan_interp( scanned, positions.size(), positions.data(), colors.data(), transform, translation );
+
+		INFO( "fan " << fanIndex );
+		auto const bytes = std::size_t(single.get_pitch())*kHeight;
+		REQUIRE( 0 == std::memcmp( single.get_surface_ptr(), scanned.get_surface_ptr(), bytes ) );
+	}
+}
+
+TEST_CASE( "Uniform triangles are filled", "[batch]" )
+{
+	constexpr std::uint32_t kWidth = 100, kHeight = 100;
+
+	Vec2f const p0{ 7.f, 5.f }, p1{ 93.f, 31.f }, p2{ 38.f, 88.f };
+
+	// Colors that differ slightly, but convert to the same sRGB color.
+	ColorF const c0{ 0.25f, 0.6f, 0.7f };
+	ColorF const c1{ 0.2501f, 0.6f, 0.7f };
+	ColorF const c2{ 0.25f, 0.5999f, 0.7001f };
+
+	auto const color = linear_to_srgb( c0 );
+
+	Surface solid( kWidth, kHeight );
+	solid.clear();
+	draw_triangle_solid( solid, p0, p1, p2, color );
+
+	Surface interp( kWidth, kHeight );
+	interp.clear();
+	draw_triangle_interp( interp, p0, p1, p2, c0, c1, c2 );
+
+	auto const bytes = std::size_t(solid.get_pitch())*kHeight;
+	REQUIRE( 0 == std::memcmp( solid.get_surface_ptr(), interp.get_surface_ptr(), bytes ) );
+
+	SECTION( "fans" )
+	{
+		auto const mode = GENERATE( EFanMode::triangles, EFanMode::scan );
+
+		TriangleFan const fan( {
+			{ { 0.f, 0.f }, c0 },
+			{ { 30.f, 0.f }, c1 },
+			{ { 10.f, 25.f }, c2 },
+			{ { -20.f, 15.f }, c0 },
+			{ { -25.f, -20.f }, c1 }
+		} );
+		REQUIRE( fan.has_uniform_color() );
+
+		Mat22f const transform = make_rotation_2d( 0.4f );
+		Vec2f const translation{ 50.f, 50.f };
+
+		Vec2f const p[5] = {
+			transform * Vec2f{ 0.f, 0.f } + translation,
+			transform * Vec2f{ 30.f, 0.f } + translation,
+			transform * Vec2f{ 10.f, 25.f } + translation,
+			transform * Vec2f{ -20.f, 15.f } + translation,
+			transform * Vec2f{ -25.f, -20.f } + translation
+		};
+
+		Surface single( kWidth, kHeight );
+		single.clear();
+		for( int i = 1; i < 5; ++i )
+			draw_triangle_solid( single, p[0], p[i], p[i < 4 ? i+1 : 1], color );
+
+		Surface filled( kWidth, kHeight );
+		filled.clear();
+		fan.draw( filled, transform, translation, mode );
+
+		REQUIRE( 0 == std::memcmp( single.get_surface_ptr(), filled.get_surface_ptr(), bytes ) );
+	}
+
+	SECTION( "non-uniform fans" )
+	{
+		TriangleFan const fan( {
+			{ { 0.f, 0.f }, c0 },
+			{ { 30.f, 0.f }, c1 },
+			{ { 10.f, 25.f }, { 0.22f, 0.6f, 0.7f } }
+		} );
+		REQUIRE( !fan.has_uniform_color() );
+	}
+}
+
+TEST_CASE( "Batched solid triangles match individual triangles", "[batch]" )
+{
+	constexpr std::uint32_t kWidth = 150, kHeight = 100;
+	constexpr std::size_t kTriangles = 60;
+
+	// Triangles, partially off screen; a few have a vertex outside of the
+	// guard band. The vertices lie just next to pixel centers, where the
+	// rasterizer's fixed point rounding decides which pixels are covered.
+	// draw_triangles_solid() must use the same fill rule as
+	// draw_triangle_solid(), so the union of the triangles is the same
+	// either way.
+	std::minstd_rand rng( 31 );
+	std::uniform_int_distribution<int> pdist( -10, int(kWidth)+10 );
+	std::uniform_int_distribution<int> ddist( -20, 20 );
+	std::uniform_int_distribution<int> edist( -1, 1 );
+
+	auto const near_center = [&] (int aX, int aY) {
+		return Vec2f{ float(aX) + 0.5f + 0.001f*float(edist( rng )), float(aY) + 0.5f + 0.001f*float(edist( rng )) };
+	};
+
+	std::vector<Vec2f> vertices;
+	for( std::size_t i = 0; i < kTriangles; ++i )
+	{
+		int const x = pdist( rng ), y = pdist( rng ) * int(kHeight) / int(kWidth);
+
+		vertices.emplace_back( near_center( x, y ) );
+		vertices.emplace_back( near_center( x + ddist( rng ), y + ddist( rng ) ) );
+		vertices.emplace_back( near_center( x + ddist( rng ), y + ddist( rng ) ) );
+
+		if( i % 13 == 0 )
+			vertices.back() = 1e5f * (vertices.back() - vertices[3*i]) + vertices[3*i];
+	}
+
+	ColorU8_sRGB const color{ 255, 255, 255 };
+
+	Surface single( kWidth, kHeight );
+	single.clear();
+	for( std::size_t i = 0; i < kTriangles; ++i )
+		draw_triangle_solid( single, vertices[3*i+0], vertices[3*i+1], vertices[3*i+2], color );
+
+	Surface batched( kWidth, kHeight );
+	batched.clear();
+	auto const written = draw_triangles_solid( batched, kTriangles, vertices.data(), color );
+
+	auto const bytes = std::size_t(single.get_pitch())*kHeight;
+	REQUIRE( 0 == std::memcmp( single.get_surface_ptr(), batched.get_surface_ptr(), bytes ) );
+
+	// Each pixel is written once
+	std::size_t lit = 0;
+	for( std::uint32_t y = 0; y < kHeight; ++y )
+	{
+		for( std::uint32_t x = 0; x < kWidth; ++x )
+			lit += 0 != batched.get_surface_ptr()[batched.get_linear_index( x, y )] ? 1 : 0;
+	}
+	REQUIRE( lit == written );
+}
@@ -0,0 +1,117 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <random>
+
+#include <cstring>
+
+#include "../draw2d/shape.hpp"
+#include "../draw2d/binner.hpp"
+#include "../draw2d/surface.hpp"
+#include "../draw2d/draw.hpp"
+
+
+TEST_CASE( "Binned triangles match direct drawing", "[binner]" )
+{
+	constexpr std::uint32_t kWidth = 200, kHeight = 130;
+	constexpr std::size_t kCount = 400;
+
+	// Overlapping triangles (so that the order matters), some partially or
+	// entirely off screen, and a few very large ones.
+	auto const draw = [] (auto&& aSolid, auto&& aInterp) {
+		std::minstd_rand rng( 5 );
+		std::uniform_real_distribution<float> pdist( -30.f, kWidth+30.f );
+		std::uniform_real_distribution<float> ddist( -40.f, 40.f );
+		std::uniform_real_distribution<float> cdist( 0.f, 1.f );
+		std::uniform_int_distribution<int> bdist( 0, 255 );
+
+		for( std::size_t i = 0; i < kCount; ++i )
+		{
+			float const scale = (i % 61 == 0) ? 1e5f : 1.f;
+			Vec2f const p0{ pdist( rng ), pdist( rng ) * kHeight / kWidth };
+			Vec2f const p1 = p0 + scale * Vec2f{ ddist( rng ), ddist( rng ) };
+			Vec2f const p2 = p0 + scale * Vec2f{ ddist( rng ), ddist( rng ) };
+
+			if( i % 3 == 0 )
+			{
+				aSolid( p0, p1, p2, ColorU8_sRGB{ 
+					std::uint8_t(bdist( rng )), 
+					std::uint8_t(bdist( rng )), 
+					std::uint8_t(bdist( rng ))
+				} );
+			}
+			else
+			{
+				aInterp( p0, p1, p2,
+					ColorF{ cdist( rng ), cdist( rng ), cdist( rng ) },
+					ColorF{ cdist( rng ), cdist( rng ), cdist( rng ) },
+					ColorF{ cdist( rng ), cdist( rng ), cdist( rng ) }
+				);
+			}
+		}
+	};
+
+	Surface direct( kWidth, kHeight );
+	direct.clear();
+	draw(
+		[&] (Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorU8_sRGB aCol) {
+			draw_triangle_solid( direct, aP0, aP1, aP2, aCol );
+		},
+		[&] (Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorF aC0, ColorF aC1, ColorF aC2) {
+			draw_triangle_interp( direct, aP0, aP1, aP2, aC0, aC1, aC2 );
+		}
+	);
+
+	auto const threads = GENERATE( std::size_t(1), std::size_t(3) );
+	auto const tileSize = GENERATE( 16, 64 );
+
+	TriangleBinner binner( threads, tileSize );
+	REQUIRE( threads == binner.thread_count() );
+
+	Surface binned( kWidth, kHeight );
+	binned.clear();
+
+	// Flush twice, to check that the binner can be reused
+	for( int pass = 0; pass < 2; ++pass )
+	{
+		draw(
+			[&] (Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorU8_sRGB aCol) {
+				binner.draw_triangle_solid( aP0, aP1, aP2, aCol );
+			},
+			[&] (Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorF aC0, ColorF aC1, ColorF aC2) {
+				binner.draw_triangle_interp( aP0, aP1, aP2, aC0, aC1, aC2 );
+			}
+		);
+
+		REQUIRE( 0 < binner.pending_count() );
+
+		binned.clear();
+		binner.flush( binned );
+
+		REQUIRE( 0 == binner.pending_count() );
+
+		auto const bytes = std::size_t(direct.get_pitch())*kHeight;
+		REQUIRE( 0 == std::memcmp( direct.get_surface_ptr(), binned.get_surface_ptr(), bytes ) );
+	}
+}
+
+TEST_CASE( "Binned fans with fewer than two vertices", "[binner]" )
+{
+	// Such fans have no triangles, and must not submit any (nor read past
+	// their vertices).
+	TriangleFan::PosAndCol const verts[] = {
+		{ { 10.f, 10.f }, { 1.f, 1.f, 1.f } }
+	};
+
+	TriangleFan const empty( 0, verts );
+	TriangleFan const single( 1, verts );
+
+	TriangleBinner binner( 1 );
+
+	Mat22f const identity = make_rotation_2d( 0.f );
+	empty.draw( binner, identity, Vec2f{ 20.f, 20.f } );
+	single.draw( binner, identity, Vec2f{ 20.f, 20.f } );
+	REQUIRE( 0 == binner.pending_count() );
+
+	REQUIRE( single.draw( binner, identity, Vec2f{ 20.f, 20.f }, PixelRect{ 0, 0, 64, 64 } ) );
+	REQUIRE( 0 == binner.pending_count() );
+}
@@ -0,0 +1,197 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <random>
+#include <vector>
+
+#include <cmath>
+#include <cstring>
+
+#include "../draw2d/shape.hpp"
+#include "../draw2d/surface.hpp"
+#include "../draw2d/draw.hpp"
+#include "../draw2d/binner.hpp"
+
+namespace
+{
+	// Star-shaped fan around the origin, like the asteroids
+	TriangleFan make_fan_( std::minstd_rand& aRng, float aRadius )
+	{
+		std::uniform_real_distribution<float> rdist( 0.5f*aRadius, aRadius );
+		std::uniform_real_distribution<float> cdist( 0.f, 1.f );
+
+		std::vector<TriangleFan::PosAndCol> verts;
+		verts.emplace_back( TriangleFan::PosAndCol{ { 0.f, 0.f }, { cdist( aRng ), cdist( aRng ), cdist( aRng ) } } );
+		for( int i = 0; i < 12; ++i )
+		{
+			float const angle = 6.2831853f * float(i) / 12.f;
+			float const radius = rdist( aRng );
+			verts.emplace_back( TriangleFan::PosAndCol{
+				{ radius * std::cos( angle ), radius * std::sin( angle ) },
+				{ cdist( aRng ), cdist( aRng ), cdist( aRng ) }
+			} );
+		}
+
+		return TriangleFan( verts.size(), verts.data() );
+	}
+}
+
+
+TEST_CASE( "Fan bounds", "[cull]" )
+{
+	TriangleFan const fan( {
+		{ { 0.f, 0.f }, { 1.f, 1.f, 1.f } },
+		{ { 3.f, -1.f }, { 1.f, 0.f, 0.f } },
+		{ { 0.f, 4.f }, { 0.f, 1.f, 0.f } },
+		{ { -2.f, 0.f }, { 0.f, 0.f, 1.f } }
+	} );
+
+	REQUIRE( fan.bounding_radius() == Catch::Approx( 4.f ) );
+	REQUIRE( fan.bounds_min().x == -2.f );
+	REQUIRE( fan.bounds_min().y == -1.f );
+	REQUIRE( fan.bounds_max().x == 3.f );
+	REQUIRE( fan.bounds_max().y == 4.f );
+}
+
+TEST_CASE( "Culled fans match unculled fans", "[cull]" )
+{
+	constexpr std::uint32_t kWidth = 160, kHeight = 100;
+	constexpr float kPadding = 60.f;
+	constexpr int kCount = 300;
+
+	auto const mode = GENERATE( EFanMode::triangles, EFanMode::scan );
+
+	// Fans scattered over the surface and a padding around it; many of them
+	// are just barely on or off screen.
+	std::minstd_rand rng( 17 );
+	std::uniform_real_distribution<float> xdist( -kPadding, kWidth + kPadding );
+	std::uniform_real_distribution<float> ydist( -kPadding, kHeight + kPadding );
+	std::uniform_real_distribution<float> adist( 0.f, 6.2831853f );
+
+	std::vector<TriangleFan> fans;
+	std::vector<Vec2f> positions;
+	std::vector<Mat22f> rotations;
+	for( int i = 0; i < kCount; ++i )
+	{
+		fans.emplace_back( make_fan_( rng, 20.f ) );
+		positions.emplace_back( Vec2f{ xdist( rng ), ydist( rng ) } );
+		rotations.emplace_back( make_rotation_2d( adist( rng ) ) );
+	}
+
+	Surface reference( kWidth, kHeight );
+	reference.clear();
+	for( int i = 0; i < kCount; ++i )
+		fans[i].draw( reference, rotations[i], positions[i], mode );
+
+	Surface culled( kWidth, kHeight );
+	culled.clear();
+
+	reset_fan_stats();
+	int drawn = 0;
+	for( int i = 0; i < kCount; ++i )
+	{
+		if( fans[i].draw( culled, rotations[i], positions[i], PixelRect{ 0, 0, int(kWidth), int(kHeight) }, mode ) )
+			++drawn;
+	}
+
+	auto const stats = fan_stats();
+	REQUIRE( std::uint64_t(drawn) == stats.drawn );
+	REQUIRE( std::uint64_t(kCount) == stats.drawn + stats.culled );
+	REQUIRE( 0 < stats.culled );
+
+	auto const bytes = std::size_t(reference.get_pitch())*kHeight;
+	REQUIRE( 0 == std::memcmp( reference.get_surface_ptr(), culled.get_surface_ptr(), bytes ) );
+}
+
+TEST_CASE( "Fans are clipped to the scissor rectangle", "[cull]" )
+{
+	constexpr std::uint32_t kWidth = 120, kHeight = 90;
+
+	auto const mode = GENERATE( EFanMode::triangles, EFanMode::scan );
+
+	std::minstd_rand rng( 3 );
+	auto const fan = make_fan_( rng, 50.f );
+
+	Mat22f const rotation = make_rotation_2d( 0.7f );
+	Vec2f const position{ 60.f, 45.f };
+
+	Surface reference( kWidth, kHeight );
+	reference.clear();
+	fan.draw( reference, rotation, position, mode );
+
+	// The scissor rectangle may extend past the surface.
+	PixelRect const scissor{ 25, -10, 83, 52 };
+
+	Surface scissored( kWidth, kHeight );
+	scissored.clear();
+	REQUIRE( fan.draw( scissored, rotation, position, scissor, mode ) );
+
+	for( std::uint32_t y = 0; y < kHeight; ++y )
+	{
+		for( std::uint32_t x = 0; x < kWidth; ++x )
+		{
+			bool const inside = int(x) >= scissor.x0 && int(x) < scissor.x1 && int(y) >= scissor.y0 && int(y) < scissor.y1;
+
+			auto const idx = reference.get_linear_index( x, y );
+			auto const expected = inside ? reference.get_surface_ptr()[idx] : std::uint8_t(0);
+			REQUIRE( expected == scissored.get_surface_ptr()[idx] );
+		}
+	}
+
+	// Entirely outside of the scissor rectangle: rejected
+	REQUIRE( !fan.draw( scissored, rotation, position + Vec2f{ 200.f, 0.f }, scissor, mode ) );
+}
+
+TEST_CASE( "Binned culled fans match binned fans", "[cull][binner]" )
+{
+	constexpr std::uint32_t kWidth = 160, kHeight = 100;
+	constexpr float kPadding = 60.f;
+	constexpr int kCount = 300;
+
+	std::minstd_rand rng( 23 );
+	std::uniform_real_distribution<float> xdist( -kPadding, kWidth + kPadding );
+	std::uniform_real_distribution<float> ydist( -kPadding, kHeight + kPadding );
+	std::uniform_real_distribution<float> adist( 0.f, 6.2831853f );
+
+	std::vector<TriangleFan> fans;
+	std::vector<Vec2f> positions;
+	std::vector<Mat22f> rotations;
+	for( int i = 0; i < kCount; ++i )
+	{
+		fans.emplace_back( make_fan_( rng, 20.f ) );
+		positions.emplace_back( Vec2f{ xdist( rng ), ydist( rng ) } );
+		rotations.emplace_back( make_rotation_2d( adist( rng ) ) );
+	}
+
+	TriangleBinner binner( 2, 32 );
+
+	Surface reference( kWidth, kHeight );
+	reference.clear();
+	for( int i = 0; i < kCount; ++i )
+		fans[i].draw( binner, rotations[i], positions[i] );
+
+	auto const unculledCount = binner.pending_count();
+	binner.flush( reference );
+
+	Surface culled( kWidth, kHeight );
+	culled.clear();
+
+	reset_fan_stats();
+	int drawn = 0;
+	for( int i = 0; i < kCount; ++i )
+	{
+		if( fans[i].draw( binner, rotations[i], positions[i], PixelRect{ 0, 0, int(kWidth), int(kHeight) } ) )
+			++drawn;
+	}
+
+	// Rejected fans never reach the binner
+	REQUIRE( binner.pending_count() < unculledCount );
+	binner.flush( culled );
+
+	auto const stats = fan_stats();
+	REQUIRE( std::uint64_t(drawn) == stats.drawn );
+	REQUIRE( std::uint64_t(kCount) == stats.drawn + stats.culled );
+	REQUIRE( 0 < stats.culled );
+
+	auto const bytes = std::size_t(reference.get_pitch())*kHeight;
+	REQUIRE( 0 == std::memcmp( reference.get_surface_ptr(), culled.get_surface_ptr(), bytes ) );
+}
@@ -0,0 +1,221 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <random>
+#include <vector>
+
+#include <cstring>
+
+#include "../draw2d/draw.hpp"
+#include "../draw2d/binner.hpp"
+#include "../draw2d/surface.hpp"
+#include "../draw2d/surface-ops.hpp"
+
+namespace
+{
+	bool inside_( std::vector<PixelRect> const& aRects, int aX, int aY )
+	{
+		for( auto const& rect : aRects )
+		{
+			if( aX >= rect.x0 && aX < rect.x1 && aY >= rect.y0 && aY < rect.y1 )
+				return true;
+		}
+		return false;
+	}
+
+	bool black_( Surface const& aSurface )
+	{
+		std::vector<std::uint8_t> const zeros( std::size_t(aSurface.get_pitch()) * aSurface.get_height(), 0 );
+		return 0 == std::memcmp( zeros.data(), aSurface.get_surface_ptr(), zeros.size() );
+	}
+}
+
+
+TEST_CASE( "New surfaces are dirty", "[dirty]" )
+{
+	Surface surface( 200, 150 );
+
+	std::vector<PixelRect> rects;
+	surface.get_dirty_rects( rects );
+
+	REQUIRE( 1 == rects.size() );
+	REQUIRE( 0 == rects[0].x0 );
+	REQUIRE( 0 == rects[0].y0 );
+	REQUIRE( 200 == rects[0].x1 );
+	REQUIRE( 150 == rects[0].y1 );
+
+	surface.clear_dirty();
+	rects.clear();
+	surface.get_dirty_rects( rects );
+	REQUIRE( rects.empty() );
+
+	// Nothing was drawn
+	surface.clear();
+	REQUIRE( 0 == surface.get_cleared_bytes() );
+}
+
+TEST_CASE( "Dirty tiles are merged", "[dirty]" )
+{
+	constexpr int kTile = int(Surface::kDirtyTileSize);
+
+	Surface surface( 5*kTile, 4*kTile + 10 );
+	surface.clear_dirty();
+
+	// Tiles [1,3) x [0,2), and the partial tiles in the last row
+	fill_rect( surface, PixelRect{ kTile+5, 3, 3*kTile-5, 2*kTile-1 }, { 255, 0, 0 } );
+	surface.set_pixel_srgb( 0, 4*kTile + 9, { 0, 255, 0 } );
+	surface.set_pixel_srgb( 5*kTile-1, 4*kTile + 2, { 0, 255, 0 } );
+
+	std::vector<PixelRect> rects;
+	surface.get_dirty_rects( rects );
+
+	REQUIRE( 3 == rects.size() );
+	REQUIRE( kTile == rects[0].x0 );
+	REQUIRE( 0 == rects[0].y0 );
+	REQUIRE( 3*kTile == rects[0].x1 );
+	REQUIRE( 2*kTile == rects[0].y1 );
+
+	REQUIRE( 0 == rects[1].x0 );
+	REQUIRE( 4*kTile == rects[1].y0 );
+	REQUIRE( kTile == rects[1].x1 );
+	REQUIRE( 4*kTile+10 == rects[1].y1 );
+
+	REQUIRE( 4*kTile == rects[2].x0 );
+	REQUIRE( 5*kTile == rects[2].x1 );
+
+	// Only the drawn tiles are cleared. They remain dirty, since they have
+	// changed again.
+	surface.clear();
+	REQUIRE( std::size_t(4*kTile*kTile + 2*kTile*10)*4 == surface.get_cleared_bytes() );
+	REQUIRE( black_( surface ) );
+
+	rects.clear();
+	surface.get_dirty_rects( rects );
+	REQUIRE( 3 == rects.size() );
+
+	surface.clear_dirty();
+	surface.clear();
+	REQUIRE( 0 == surface.get_cleared_bytes() );
+
+	// A black fill leaves nothing to clear, but everything is dirty
+	surface.fill( { 0, 0, 0 } );
+	surface.clear();
+	REQUIRE( 0 == surface.get_cleared_bytes() );
+
+	rects.clear();
+	surface.get_dirty_rects( rects );
+	REQUIRE( 1 == rects.size() );
+}
+
+TEST_CASE( "Drawing marks the written pixels", "[dirty]" )
+{
+	constexpr std::uint32_t kWidth = 300, kHeight = 200;
+
+	// Small primitives, scattered over the surface and its surroundings, so
+	// that most tiles remain clean.
+	std::minstd_rand rng( 29 );
+	std::uniform_real_distribution<float> pdist( -20.f, kWidth+20.f );
+	std::uniform_real_distribution<float> ddist( -15.f, 15.f );
+	std::uniform_real_distribution<float> cdist( 0.f, 1.f );
+
+	auto const point = [&] {
+		return Vec2f{ pdist( rng ), pdist( rng ) * kHeight / kWidth };
+	};
+	auto const near = [&] (Vec2f aP) {
+		return aP + Vec2f{ ddist( rng ), ddist( rng ) };
+	};
+	auto const color = [&] {
+		return ColorF{ cdist( rng ), cdist( rng ), cdist( rng ) };
+	};
+
+	auto const kind = GENERATE( range( 0, 14 ) );
+	INFO( "kind " << kind );
+
+	Surface surface( kWidth, kHeight );
+	surface.clear_dirty();
+
+	TriangleBinner binner( 2, 32 );
+
+	ColorU8_sRGB const white{ 255, 255, 255 };
+	for( int i = 0; i < 8; ++i )
+	{
+		Vec2f const p0 = point(), p1 = near( p0 ), p2 = near( p0 );
+		switch( kind )
+		{
+			case 0: draw_line_solid( surface, p0, p1, white ); break;
+			case 1:
+			{
+				// Short lines go to the multi-line kernel, if available
+				float const x0[2] = { p0.x, p2.x }, y0[2] = { p0.y, p2.y };
+				float const x1[2] = { p1.x, p0.x }, y1[2] = { p1.y, p0.y };
+				draw_lines_solid( surface, 2, x0, y0, x1, y1, white );
+			} break;
+			case 2: draw_line_aa( surface, p0, p1, white ); break;
+			case 3: draw_triangle_solid( surface, p0, p1, p2, white ); break;
+			case 4: draw_triangle_interp( surface, p0, p1, p2, color(), color(), color() ); break;
+			case 5:
+			{
+				Vec2f const verts[3] = { p0, p1, p2 };
+				draw_triangles_solid( surface, 1, verts, white );
+			} break;
+			case 6:
+			{
+				Vec2f const pos[3] = { p0, p1, p2 };
+				ColorF const cols[3] = { color(), color(), color() };
+				std::uint32_t const indices[3] = { 0, 1, 2 };
+				draw_triangles_interp( surface, 3, pos, cols, 1, indices, Mat22f{ 1.f, 0.f, 0.f, 1.f }, Vec2f{ 0.f, 0.f } );
+			} break;
+			case 7:
+			{
+				Vec2f const pos[4] = { { 0.f, 0.f }, p1 - p0, p2 - p0, p0 - p1 };
+				ColorF const cols[4] = { color(), color(), color(), color() };
+				draw_triangle_fan_interp( surface, 4, pos, cols, make_rotation_2d( 0.5f ), p0 );
+			} break;
+			case 8: draw_rectangle_solid( surface, p0, p1, white ); break;
+			case 9: draw_rectangle_outline( surface, p0, p0 + Vec2f{ 70.f, 50.f }, white ); break;
+			case 10: fill_rect( surface, PixelRect{ int(p0.x), int(p0.y), int(p1.x), int(p1.y) }, white ); break;
+			case 11:
+			{
+				// Copy from a (white) surface
+				Surface source( 40, 40 );
+				source.fill( white );
+				copy_rect( surface, int(p0.x), int(p0.y), source, PixelRect{ 0, 0, 40, 40 } );
+			} break;
+			case 12:
+			{
+				if( p0.x >= 0.f && p0.x < kWidth && p0.y >= 0.f && p0.y < kHeight )
+				{
+					auto const x = Surface::Index(p0.x), y = Surface::Index(p0.y);
+					surface.set_pixel_srgb( x, y, white );
+					surface.write_span( y, x/2, x, pack_rgbx( white ) );
+				}
+			} break;
+			case 13: binner.draw_triangle_interp( p0, p1, p2, color(), color(), color() ); break;
+		}
+	}
+	binner.flush( surface );
+
+	std::vector<PixelRect> rects;
+	surface.get_dirty_rects( rects );
+
+	std::size_t lit = 0;
+	for( std::uint32_t y = 0; y < kHeight; ++y )
+	{
+		for( std::uint32_t x = 0; x < kWidth; ++x )
+		{
+			auto const* pixel = surface.get_surface_ptr() + surface.get_linear_index( x, y );
+			if( 0 == pixel[0] && 0 == pixel[1] && 0 == pixel[2] )
+				continue;
+
+			++lit;
+			REQUIRE( inside_( rects, int(x), int(y) ) );
+		}
+	}
+
+	REQUIRE( 0 < lit );
+
+	// Clearing only the drawn tiles leaves a black surface
+	surface.clear();
+	REQUIRE( black_( surface ) );
+	REQUIRE( 0 < surface.get_cleared_bytes() );
+	REQUIRE( surface.get_cleared_bytes() < std::size_t(kWidth)*kHeight*4 );
+}
@@ -8,7 +8,7 @@ ColorU8_sRGB find_most_red_pixel( Surface const& aSurface )
 {
 	ColorU8_sRGB ret{ 0, 0, 0 };
 
-	auto const stride = aSurface.get_width() << 2;
+	auto const stride = aSurface.get_pitch();
 	for( std::uint32_t x = 0; x < aSurface.get_width(); ++x )
 	{
 		for( std::uint32_t y = 0; y < aSurface.get_height(); ++y )
@@ -35,7 +35,7 @@ ColorU8_sRGB find_least_red_nonzero_pixel( Surface const& aSurface )
 {
 	ColorU8_sRGB ret{ 255, 255, 255 };
 
-	auto const stride = aSurface.get_width() << 2;
+	auto const stride = aSurface.get_pitch();
 	for( std::uint32_t x = 0; x < aSurface.get_width(); ++x )
 	{
 		for( std::uint32_t y = 0; y < aSurface.get_height(); ++y )
@@ -0,0 +1,131 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <random>
+#include <algorithm>
+
+#include <cmath>
+#include <cstring>
+
+#include "../draw2d/cpu.hpp"
+#include "../draw2d/surface.hpp"
+#include "../draw2d/draw.hpp"
+
+
+TEST_CASE( "Solid rectangles match two triangles", "[rectangle]" )
+{
+	auto const level = GENERATE( ESimdLevel::scalar, ESimdLevel::avx2 );
+	set_simd_level_limit( level );
+
+	// Coordinates are on a quarter-pixel grid, which the triangles represent
+	// exactly, so pixel centers on the edges are handled identically.
+	// Rectangles may be partially or entirely off screen, or empty.
+	constexpr std::uint32_t kWidth = 150, kHeight = 100;
+
+	std::minstd_rand rng( 5 );
+	std::uniform_int_distribution<int> xdist( -120, 4*kWidth+120 );
+	std::uniform_int_distribution<int> ydist( -120, 4*kHeight+120 );
+	std::uniform_int_distribution<int> cdist( 1, 255 );
+
+	for( int i = 0; i < 200; ++i )
+	{
+		Vec2f const a{ 0.25f*xdist( rng ), 0.25f*ydist( rng ) };
+		Vec2f const b{ 0.25f*xdist( rng ), 0.25f*ydist( rng ) };
+		ColorU8_sRGB const color{ std::uint8_t(cdist( rng )), std::uint8_t(cdist( rng )), std::uint8_t(cdist( rng )) };
+
+		Surface triangles( kWidth, kHeight );
+		triangles.clear();
+
+		Vec2f const lo{ std::min( a.x, b.x ), std::min( a.y, b.y ) };
+		Vec2f const hi{ std::max( a.x, b.x ), std::max( a.y, b.y ) };
+		draw_triangle_solid( triangles, lo, Vec2f{ hi.x, lo.y }, hi, color );
+		draw_triangle_solid( triangles, lo, hi, Vec2f{ lo.x, hi.y }, color );
+
+		Surface rectangle( kWidth, kHeight );
+		rectangle.clear();
+		draw_rectangle_solid( rectangle, a, b, color );
+
+		INFO( "rectangle " << i );
+		auto const bytes = std::size_t(triangles.get_pitch())*kHeight;
+		REQUIRE( 0 == std::memcmp( triangles.get_surface_ptr(), rectangle.get_surface_ptr(), bytes ) );
+	}
+
+	set_simd_level_limit( ESimdLevel::avx2 );
+}
+
+TEST_CASE( "Large solid rectangles", "[rectangle]" )
+{
+	auto const level = GENERATE( ESimdLevel::scalar, ESimdLevel::avx2 );
+	set_simd_level_limit( level );
+
+	// Large enough for streaming stores. Odd sizes and offsets leave
+	// unaligned pixels at the start and end of each row.
+	constexpr std::uint32_t kWidth = 1283, kHeight = 777;
+
+	Surface surface( kWidth, kHeight );
+	surface.clear();
+
+	draw_rectangle_solid( surface, { 3.f, 2.f }, { kWidth - 1.f, kHeight - 1.f }, { 255, 128, 7 } );
+
+	for( std::uint32_t y = 0; y < kHeight; ++y )
+	{
+		for( std::uint32_t x = 0; x < kWidth; ++x )
+		{
+			bool const inside = x >= 3 && x < kWidth-1 && y >= 2 && y < kHeight-1;
+
+			auto const idx = surface.get_linear_index( x, y );
+			auto const* pixel = surface.get_surface_ptr() + idx;
+			if( (inside ? 255 : 0) != pixel[0] || (inside ? 7 : 0) != pixel[2] )
+			{
+				INFO( "pixel " << x << ", " << y );
+				REQUIRE( false );
+			}
+		}
+	}
+
+	set_simd_level_limit( ESimdLevel::avx2 );
+}
+
+TEST_CASE( "Rectangle outlines", "[rectangle]" )
+{
+	constexpr std::uint32_t kWidth = 60, kHeight = 40;
+
+	std::minstd_rand rng( 9 );
+	std::uniform_real_distribution<float> xdist( -10.f, kWidth+10.f );
+	std::uniform_real_distribution<float> ydist( -10.f, kHeight+10.f );
+
+	for( int i = 0; i < 100; ++i )
+	{
+		Vec2f const a{ xdist( rng ), ydist( rng ) };
+		Vec2f const b = 0 == i % 10
+			? a + Vec2f{ 0.7f, 5.f } // thin rectangles
+			: Vec2f{ xdist( rng ), ydist( rng ) }
+		;
+
+		Surface surface( kWidth, kHeight );
+		surface.clear();
+		draw_rectangle_outline( surface, a, b, { 255, 255, 255 } );
+
+		// Outermost pixels of the solid rectangle, before clipping
+		int const x0 = int(std::ceil( std::min( a.x, b.x ) - 0.5f ));
+		int const x1 = int(std::ceil( std::max( a.x, b.x ) - 0.5f ));
+		int const y0 = int(std::ceil( std::min( a.y, b.y ) - 0.5f ));
+		int const y1 = int(std::ceil( std::max( a.y, b.y ) - 0.5f ));
+
+		INFO( "rectangle " << i );
+		for( int y = 0; y < int(kHeight); ++y )
+		{
+			for( int x = 0; x < int(kWidth); ++x )
+			{
+				bool const inside = x >= x0 && x < x1 && y >= y0 && y < y1;
+				bool const border = inside && (x == x0 || x == x1-1 || y == y0 || y == y1-1);
+
+				auto const idx = surface.get_linear_index( std::uint32_t(x), std::uint32_t(y) );
+				if( (border ? 255 : 0) != surface.get_surface_ptr()[idx] )
+				{
+					INFO( "pixel " << x << ", " << y );
+					REQUIRE( false );
+				}
+			}
+		}
+	}
+}
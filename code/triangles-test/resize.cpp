@@ -0,0 +1,142 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <vector>
+#include <utility>
+#include <iterator>
+
+#include <cstring>
+
+#include "../draw2d/surface.hpp"
+#include "../draw2d/surface-ops.hpp"
+
+namespace
+{
+	bool black_( Surface const& aSurface )
+	{
+		std::vector<std::uint8_t> const zeros( std::size_t(aSurface.get_pitch()) * aSurface.get_height(), 0 );
+		return 0 == std::memcmp( zeros.data(), aSurface.get_surface_ptr(), zeros.size() );
+	}
+}
+
+
+TEST_CASE( "Surfaces are reused when resized", "[resize]" )
+{
+	reset_surface_alloc_stats();
+
+	Surface surface( 640, 480 );
+	auto const capacity = surface.get_capacity();
+	auto const* storage = surface.get_surface_ptr();
+
+	REQUIRE( 1 == surface_alloc_stats().allocations );
+	REQUIRE( capacity == std::size_t(surface.get_pitch()) * 480 );
+
+	// Shrinking (in one or both dimensions) and growing back keeps the
+	// storage
+	std::pair<Surface::Index,Surface::Index> const sizes[] = {
+		{ 320, 240 }, { 639, 480 }, { 1, 1 }, { 640, 100 }, { 17, 480 }, { 640, 480 }
+	};
+
+	for( auto const& [width, height] : sizes )
+	{
+		INFO( width << "x" << height );
+
+		surface.fill( { 255, 255, 255 } );
+		surface.resize( width, height );
+
+		REQUIRE( width == surface.get_width() );
+		REQUIRE( height == surface.get_height() );
+		REQUIRE( 0 == surface.get_pitch() % Surface::kSurfaceAlignment );
+		REQUIRE( surface.get_pitch() >= 4*width );
+
+		REQUIRE( storage == surface.get_surface_ptr() );
+		REQUIRE( capacity == surface.get_capacity() );
+
+		// Like a new surface: black and dirty
+		REQUIRE( black_( surface ) );
+
+		std::vector<PixelRect> rects;
+		surface.get_dirty_rects( rects );
+		REQUIRE( 1 == rects.size() );
+		REQUIRE( int(width) == rects[0].x1 );
+		REQUIRE( int(height) == rects[0].y1 );
+
+		surface.clear_dirty();
+		surface.clear();
+		REQUIRE( 0 == surface.get_cleared_bytes() );
+	}
+
+	auto const stats = surface_alloc_stats();
+	REQUIRE( 1 == stats.allocations );
+	REQUIRE( 0 == stats.deallocations );
+	REQUIRE( std::size(sizes) == stats.reuses );
+}
+
+TEST_CASE( "Surfaces grow with headroom", "[resize]" )
+{
+	reset_surface_alloc_stats();
+
+	{
+		Surface surface( 256, 256 );
+		auto const initial = surface.get_capacity();
+
+		// Growing past the capacity reallocates, with headroom for the next
+		// few steps of an interactive resize.
+		surface.resize( 264, 256 );
+		REQUIRE( 2 == surface_alloc_stats().allocations );
+		REQUIRE( surface.get_capacity() >= initial + initial/2 );
+		REQUIRE( black_( surface ) );
+
+		for( Surface::Index width = 272; width <= 320; width += 8 )
+		{
+			surface.resize( width, 256 );
+			fill_rect( surface, PixelRect{ 0, 0, int(width), 256 }, { 0, 0, 255 } );
+		}
+		REQUIRE( 2 == surface_alloc_stats().allocations );
+
+		// Moving transfers the storage
+		Surface moved( std::move( surface ) );
+		REQUIRE( 320 == moved.get_width() );
+		REQUIRE( 0 == surface.get_capacity() );
+	}
+
+	auto const stats = surface_alloc_stats();
+	REQUIRE( 2 == stats.allocations );
+	REQUIRE( 2 == stats.deallocations );
+	REQUIRE( 7 == stats.reuses );
+}
+
+TEST_CASE( "Surfaces backed by huge pages", "[resize]" )
+{
+	// Whether huge pages are available depends on the system; all backings
+	// must behave the same.
+	set_surface_huge_pages( true );
+
+	Surface small( 64, 64 );
+	Surface large( 1500, 1000 );
+	set_surface_huge_pages( false );
+
+	REQUIRE( ESurfaceStorage::heap == small.get_storage() );
+	INFO( "large: " << to_string( large.get_storage() ) );
+
+	auto const address = reinterpret_cast<std::uintptr_t>(large.get_surface_ptr());
+	REQUIRE( 0 == address % Surface::kSurfaceAlignment );
+	REQUIRE( large.get_capacity() >= std::size_t(large.get_pitch()) * large.get_height() );
+	REQUIRE( black_( large ) );
+
+	large.fill( { 1, 2, 3 } );
+	REQUIRE( large.get_surface_ptr()[large.get_linear_index( 1499, 999 )+2] == 3 );
+
+	// Resizing keeps the backing, and moves transfer it
+	auto const storage = large.get_storage();
+	large.resize( 1000, 1000 );
+	REQUIRE( storage == large.get_storage() );
+	REQUIRE( black_( large ) );
+
+	Surface moved( std::move( large ) );
+	REQUIRE( storage == moved.get_storage() );
+	REQUIRE( ESurfaceStorage::heap == large.get_storage() );
+
+	// Growing reallocates with the current setting
+	moved.resize( 2000, 1000 );
+	REQUIRE( ESurfaceStorage::heap == moved.get_storage() );
+}
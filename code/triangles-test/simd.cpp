@@ -0,0 +1,59 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <random>
+
+#include <cstring>
+
+#include "../draw2d/cpu.hpp"
+#include "../draw2d/surface.hpp"
+#include "../draw2d/draw.hpp"
+
+
+TEST_CASE( "Interp SIMD matches scalar", "[interp][simd]" )
+{
+	constexpr std::uint32_t kWidth = 160, kHeight = 120;
+	constexpr std::size_t kCount = 500;
+
+	// Overlapping triangles of different sizes, some of them partially off
+	// screen. Small and thin triangles exercise the partial (masked) groups
+	// of pixels.
+	std::minstd_rand rng( 11 );
+	std::uniform_real_distribution<float> pdist( -20.f, kWidth+20.f );
+	std::uniform_real_distribution<float> ddist( -30.f, 30.f );
+	std::uniform_real_distribution<float> cdist( 0.f, 1.f );
+
+	auto const draw = [&] (Surface& aSurface) {
+		rng.seed( 11 );
+		for( std::size_t i = 0; i < kCount; ++i )
+		{
+			float const scale = (i % 50 == 0) ? 4.f : (i % 3 == 0 ? 0.2f : 1.f);
+			Vec2f const p0{ pdist( rng ), pdist( rng ) * kHeight / kWidth };
+			Vec2f const p1 = p0 + scale * Vec2f{ ddist( rng ), ddist( rng ) };
+			Vec2f const p2 = p0 + scale * Vec2f{ ddist( rng ), ddist( rng ) };
+
+			draw_triangle_interp( aSurface, p0, p1, p2,
+				{ cdist( rng ), cdist( rng ), cdist( rng ) },
+				{ cdist( rng ), cdist( rng ), cdist( rng ) },
+				{ cdist( rng ), cdist( rng ), cdist( rng ) }
+			);
+		}
+	};
+
+	set_simd_level_limit( ESimdLevel::scalar );
+
+	Surface scalar( kWidth, kHeight );
+	scalar.clear();
+	draw( scalar );
+
+	set_simd_level_limit( ESimdLevel::avx2 );
+
+	if( ESimdLevel::avx2 > detected_simd_level() )
+		SKIP( "SIMD level not supported by this CPU" );
+
+	Surface simd( kWidth, kHeight );
+	simd.clear();
+	draw( simd );
+
+	auto const bytes = std::size_t(scalar.get_pitch())*kHeight;
+	REQUIRE( 0 == std::memcmp( scalar.get_surface_ptr(), simd.get_surface_ptr(), bytes ) );
+}
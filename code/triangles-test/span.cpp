@@ -0,0 +1,111 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <random>
+#include <vector>
+
+#include <cstring>
+
+#include "../draw2d/image.hpp"
+#include "../draw2d/surface.hpp"
+
+namespace
+{
+	// Image with random colors and a random alpha mask
+	struct TestImage_ : ImageRGBA
+	{
+		TestImage_( Index aWidth, Index aHeight, std::uint32_t aSeed )
+			: pixels( std::size_t(aWidth)*aHeight*4 )
+		{
+			std::minstd_rand rng( aSeed );
+			std::uniform_int_distribution<int> bdist( 0, 255 );
+			for( auto& byte : pixels )
+				byte = std::uint8_t(bdist( rng ));
+
+			mWidth = aWidth;
+			mHeight = aHeight;
+			mData = pixels.data();
+		}
+
+		std::vector<std::uint8_t> pixels;
+	};
+
+	// Reference: one pixel at a time, with set_pixel_srgb()
+	void blit_reference_( Surface& aSurface, ImageRGBA const& aImage, Vec2f aPosition )
+	{
+		for( ImageRGBA::Index y = 0; y < aImage.get_height(); ++y )
+		{
+			for( ImageRGBA::Index x = 0; x < aImage.get_width(); ++x )
+			{
+				auto const pixel = aImage.get_pixel( x, y );
+				if( pixel.a < 128 )
+					continue;
+
+				float const dx = aPosition.x + float(x);
+				float const dy = aPosition.y + float(y);
+				if( dx >= 0.f && dx < float(aSurface.get_width()) && dy >= 0.f && dy < float(aSurface.get_height()) )
+					aSurface.set_pixel_srgb( Surface::Index(dx), Surface::Index(dy), { pixel.r, pixel.g, pixel.b } );
+			}
+		}
+	}
+}
+
+
+TEST_CASE( "Span writes match set_pixel_srgb", "[span]" )
+{
+	constexpr std::uint32_t kWidth = 41, kHeight = 7;
+
+	Surface spans( kWidth, kHeight );
+	Surface pixels( kWidth, kHeight );
+	spans.clear();
+	pixels.clear();
+
+	ColorU8_sRGB const color{ 10, 200, 30 };
+	spans.write_span( 2, 5, 33, pack_rgbx( color ) );
+	for( std::uint32_t x = 5; x < 33; ++x )
+		pixels.set_pixel_srgb( x, 2, color );
+
+	std::vector<PixelRGBx32> row;
+	for( std::uint32_t x = 0; x < kWidth; ++x )
+	{
+		ColorU8_sRGB const c{ std::uint8_t(x), std::uint8_t(3*x), std::uint8_t(255-x) };
+		row.emplace_back( pack_rgbx( c ) );
+		pixels.set_pixel_srgb( x, 5, c );
+	}
+	spans.write_span_colors( 5, 0, kWidth, row.data() );
+
+	// Empty spans write nothing.
+	spans.write_span( 3, 7, 7, pack_rgbx( color ) );
+
+	auto const bytes = std::size_t(pixels.get_pitch())*kHeight;
+	REQUIRE( 0 == std::memcmp( pixels.get_surface_ptr(), spans.get_surface_ptr(), bytes ) );
+}
+
+TEST_CASE( "Masked blits", "[span]" )
+{
+	constexpr std::uint32_t kWidth = 64, kHeight = 48;
+
+	TestImage_ const image( 37, 23, 99 );
+
+	// Inside, partially off each side, fractional positions, and far away
+	Vec2f const position = GENERATE(
+		Vec2f{ 10.f, 12.f },
+		Vec2f{ -5.f, 3.f },
+		Vec2f{ 50.f, -9.f },
+		Vec2f{ 40.5f, 30.25f },
+		Vec2f{ -0.5f, -10.75f },
+		Vec2f{ -1e9f, 0.f },
+		Vec2f{ 1e9f, 1e9f }
+	);
+
+	Surface reference( kWidth, kHeight );
+	reference.clear();
+	blit_reference_( reference, image, position );
+
+	Surface surface( kWidth, kHeight );
+	surface.clear();
+	blit_masked( surface, image, position );
+
+	INFO( "position " << position.x << ", " << position.y );
+	auto const bytes = std::size_t(reference.get_pitch())*kHeight;
+	REQUIRE( 0 == std::memcmp( reference.get_surface_ptr(), surface.get_surface_ptr(), bytes ) );
+}
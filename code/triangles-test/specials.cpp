@@ -22,3 +22,49 @@ TEST_CASE( "Fullscreen", "[special]" )
 	REQUIRE( 0 == int(col.g) );
 	REQUIRE( 0 == int(col.b) );
 }
+
+TEST_CASE( "Rasterizer statistics", "[special][stats]" )
+{
+	Surface surface( 320, 240 );
+	surface.clear();
+
+	reset_raster_stats();
+
+	SECTION( "Covering" )
+	{
+		// Entirely covers the surface, so every band is inside
+		draw_triangle_solid( surface,
+			{ -5.f, -5.f }, { 700.f, -5.f }, { -5.f, 500.f },
+			{ 255, 255, 255 }
+		);
+
+		auto const stats = raster_stats();
+		REQUIRE( 1 == stats.triangles );
+		REQUIRE( 0 == stats.edgeTests );
+		REQUIRE( 0 == stats.bandsPartial );
+		REQUIRE( 240/kRasterBlock == stats.bandsInside );
+		REQUIRE( 320*240 == stats.pixelsWritten );
+	}
+
+	SECTION( "Partial" )
+	{
+		draw_triangle_solid( surface,
+			{ 10.3f, 5.7f }, { 300.1f, 20.2f }, { 40.6f, 230.4f },
+			{ 255, 255, 255 }
+		);
+
+		std::uint64_t lit = 0;
+		auto const* ptr = surface.get_surface_ptr();
+		for( std::size_t i = 0; i < surface.get_pitch()/4*240; ++i )
+			lit += (0 != ptr[4*i]) ? 1 : 0;
+
+		auto const stats = raster_stats();
+		REQUIRE( 1 == stats.triangles );
+		REQUIRE( lit == stats.pixelsWritten );
+		REQUIRE( lit < stats.boundsPixels );
+
+		// At most one test per edge and row
+		REQUIRE( 0 < stats.edgeTests );
+		REQUIRE( stats.edgeTests <= 3*225 );
+	}
+}
@@ -1,16 +1,26 @@
 #include <catch2/catch_amalgamated.hpp>
 
+#include <cmath>
+
 #include "helpers.hpp"
 
 #include "../draw2d/surface.hpp"
 #include "../draw2d/draw.hpp"
 #include "../draw2d/color.hpp"
 
+namespace
+{
+	// Converted during static initialization, possibly before anything in
+	// color.cpp has been initialized.
+	ColorU8_sRGB const kStaticColor = linear_to_srgb( ColorF{ 0.5f, 0.2f, 1.f } );
+	float const kStaticLinear = linear_from_srgb( std::uint8_t(188) );
+}
+
 
 TEST_CASE( "sRGB conversion", "[interp][sRGB]" )
 {
-#	if DRAW2D_CFG_SRGB_MODE != DRAW2D_CFG_SRGB_EXACT
-#		error "These tests require SRGB_MODE == SRGB_EXACT"
+#	if DRAW2D_CFG_SRGB_MODE != DRAW2D_CFG_SRGB_EXACT && DRAW2D_CFG_SRGB_MODE != DRAW2D_CFG_SRGB_LUT
+#		error "These tests require SRGB_MODE == SRGB_EXACT or SRGB_LUT"
 #	endif
 	
 	Surface surface( 16, 16 );
@@ -49,3 +59,59 @@ TEST_CASE( "sRGB conversion", "[interp][sRGB]" )
 		REQUIRE( 192 == int(col.b) );
 	}
 }
+
+TEST_CASE( "sRGB conversion modes", "[sRGB]" )
+{
+	SECTION( "static initialization" )
+	{
+		REQUIRE( linear_to_srgb_exact( 0.5f ) == kStaticColor.r );
+		REQUIRE( linear_to_srgb_exact( 0.2f ) == kStaticColor.g );
+		REQUIRE( 255 == kStaticColor.b );
+		REQUIRE( linear_from_srgb_exact( 188 ) == kStaticLinear );
+	}
+
+	// The configured conversion must match the published one to the LSB,
+	// including at the rounding thresholds.
+	SECTION( "thresholds" )
+	{
+		for( std::size_t k = 1; k < 256; ++k )
+		{
+			float const t = srgb_luts().toSrgbThreshold[k];
+			REQUIRE( int(linear_to_srgb_exact( t )) == int(k) );
+			REQUIRE( int(linear_to_srgb( t )) == int(k) );
+
+			float const below = std::nextafter( t, 0.f );
+			REQUIRE( int(linear_to_srgb_exact( below )) == int(k-1) );
+			REQUIRE( int(linear_to_srgb( below )) == int(k-1) );
+		}
+	}
+
+	SECTION( "sweep" )
+	{
+		for( int i = 0; i <= 1000000; ++i )
+		{
+			float const value = float(i) / 1000000.f;
+			REQUIRE( int(linear_to_srgb( value )) == int(linear_to_srgb_exact( value )) );
+		}
+	}
+
+	SECTION( "batch" )
+	{
+		ColorF const colors[] = {
+			{ 0.5f, 0.5f, 0.5f },
+			{ 0.212f, 0.051f, 0.527f },
+			{ 0.f, 1.f, 0.0031308f }
+		};
+
+		ColorU8_sRGB out[3];
+		linear_to_srgb( 3, colors, out );
+
+		for( std::size_t i = 0; i < 3; ++i )
+		{
+			auto const ref = linear_to_srgb( colors[i] );
+			REQUIRE( int(ref.r) == int(out[i].r) );
+			REQUIRE( int(ref.g) == int(out[i].g) );
+			REQUIRE( int(ref.b) == int(out[i].b) );
+		}
+	}
+}
@@ -0,0 +1,219 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <utility>
+
+#include <cstring>
+
+#include "../draw2d/cpu.hpp"
+#include "../draw2d/surface.hpp"
+#include "../draw2d/surface-ops.hpp"
+
+namespace
+{
+	// Fill every pixel with a different value, such that copies can be
+	// checked pixel by pixel.
+	void fill_pattern_( Surface& aSurface, std::uint32_t aSeed )
+	{
+		for( std::uint32_t y = 0; y < aSurface.get_height(); ++y )
+		{
+			for( std::uint32_t x = 0; x < aSurface.get_width(); ++x )
+			{
+				std::uint32_t const v = (x * 2654435761u) ^ (y * 40503u) ^ aSeed;
+				aSurface.set_pixel_srgb( x, y, { std::uint8_t(v), std::uint8_t(v >> 8), std::uint8_t(v >> 16) } );
+			}
+		}
+	}
+
+	std::uint32_t pixel_( Surface const& aSurface, int aX, int aY )
+	{
+		std::uint32_t ret;
+		std::memcpy( &ret, aSurface.get_surface_ptr() + aSurface.get_linear_index( std::uint32_t(aX), std::uint32_t(aY) ), sizeof(ret) );
+		return ret;
+	}
+}
+
+
+TEST_CASE( "Surface fill", "[surface]" )
+{
+	auto const level = GENERATE( ESimdLevel::scalar, ESimdLevel::avx2 );
+	auto const mode = GENERATE( EStoreMode::automatic, EStoreMode::regular, EStoreMode::streaming );
+
+	set_simd_level_limit( level );
+	set_store_mode( mode );
+
+	Surface surface( 257, 33 );
+	surface.fill( { 1, 2, 3 } );
+
+	for( std::uint32_t y = 0; y < surface.get_height(); ++y )
+	{
+		for( std::uint32_t x = 0; x < surface.get_width(); ++x )
+		{
+			auto const* pixel = surface.get_surface_ptr() + surface.get_linear_index( x, y );
+			REQUIRE( 1 == pixel[0] );
+			REQUIRE( 2 == pixel[1] );
+			REQUIRE( 3 == pixel[2] );
+			REQUIRE( 0 == pixel[3] );
+		}
+	}
+
+	surface.clear();
+	for( std::size_t i = 0; i < std::size_t(surface.get_pitch())*33; ++i )
+		REQUIRE( 0 == surface.get_surface_ptr()[i] );
+
+	set_store_mode( EStoreMode::automatic );
+	set_simd_level_limit( ESimdLevel::avx2 );
+}
+
+TEST_CASE( "Surface rows are aligned", "[surface]" )
+{
+	auto const width = GENERATE( 1u, 15u, 16u, 17u, 257u );
+
+	Surface surface( width, 9 );
+	REQUIRE( 0 == surface.get_pitch() % Surface::kSurfaceAlignment );
+	REQUIRE( surface.get_pitch() >= 4*width );
+	REQUIRE( surface.get_pitch() < 4*width + Surface::kSurfaceAlignment );
+
+	for( std::uint32_t y = 0; y < surface.get_height(); ++y )
+	{
+		auto const address = reinterpret_cast<std::uintptr_t>(surface.get_row_ptr( y ));
+		REQUIRE( 0 == address % Surface::kSurfaceAlignment );
+		REQUIRE( surface.get_row_ptr( y ) == reinterpret_cast<PixelRGBx32 const*>(surface.get_surface_ptr() + surface.get_linear_index( 0, y )) );
+	}
+
+	// The padding after each row is zero and stays that way.
+	surface.fill( { 255, 255, 255 } );
+	fill_rect( surface, PixelRect{ -5, -5, int(width)+5, 20 }, { 255, 255, 255 } );
+
+	for( std::uint32_t y = 0; y < surface.get_height(); ++y )
+	{
+		auto const* row = surface.get_surface_ptr() + surface.get_linear_index( 0, y );
+		for( std::uint32_t i = 4*width; i < surface.get_pitch(); ++i )
+			REQUIRE( 0 == row[i] );
+	}
+
+	// Moves keep the pitch
+	Surface moved( std::move( surface ) );
+	REQUIRE( 0 == moved.get_pitch() % Surface::kSurfaceAlignment );
+	REQUIRE( moved.get_pitch() >= 4*width );
+}
+
+TEST_CASE( "Rectangle fills are clipped", "[surface]" )
+{
+	auto const level = GENERATE( ESimdLevel::scalar, ESimdLevel::avx2 );
+	auto const mode = GENERATE( EStoreMode::regular, EStoreMode::streaming );
+
+	set_simd_level_limit( level );
+	set_store_mode( mode );
+
+	constexpr int kWidth = 90, kHeight = 50;
+
+	std::minstd_rand rng( 3 );
+	std::uniform_int_distribution<int> xdist( -20, kWidth+20 );
+	std::uniform_int_distribution<int> ydist( -20, kHeight+20 );
+
+	Surface surface( kWidth, kHeight );
+	Surface reference( kWidth, kHeight );
+	surface.clear();
+	reference.clear();
+
+	for( int i = 0; i < 100; ++i )
+	{
+		PixelRect const rect{ xdist( rng ), ydist( rng ), xdist( rng ), ydist( rng ) };
+		ColorU8_sRGB const color{ std::uint8_t(i), std::uint8_t(3*i), std::uint8_t(7*i) };
+
+		fill_rect( surface, rect, color );
+
+		for( int y = std::max( rect.y0, 0 ); y < std::min( rect.y1, kHeight ); ++y )
+		{
+			for( int x = std::max( rect.x0, 0 ); x < std::min( rect.x1, kWidth ); ++x )
+				reference.set_pixel_srgb( std::uint32_t(x), std::uint32_t(y), color );
+		}
+	}
+
+	auto const bytes = std::size_t(reference.get_pitch())*kHeight;
+	REQUIRE( 0 == std::memcmp( reference.get_surface_ptr(), surface.get_surface_ptr(), bytes ) );
+
+	set_store_mode( EStoreMode::automatic );
+	set_simd_level_limit( ESimdLevel::avx2 );
+}
+
+TEST_CASE( "Rectangle copies", "[surface]" )
+{
+	auto const level = GENERATE( ESimdLevel::scalar, ESimdLevel::avx2 );
+	auto const mode = GENERATE( EStoreMode::regular, EStoreMode::streaming );
+
+	set_simd_level_limit( level );
+	set_store_mode( mode );
+
+	constexpr int kSrcWidth = 70, kSrcHeight = 45;
+	constexpr int kDstWidth = 83, kDstHeight = 38;
+
+	std::minstd_rand rng( 8 );
+	std::uniform_int_distribution<int> xdist( -25, kSrcWidth+25 );
+	std::uniform_int_distribution<int> ydist( -25, kSrcHeight+25 );
+
+	Surface source( kSrcWidth, kSrcHeight );
+	fill_pattern_( source, 0x5a5a5au );
+
+	auto const within = GENERATE( false, true );
+
+	for( int i = 0; i < 100; ++i )
+	{
+		PixelRect const rect{ xdist( rng ), ydist( rng ), xdist( rng ), ydist( rng ) };
+		int const dstX = xdist( rng ), dstY = ydist( rng );
+
+		if( !within )
+		{
+			Surface dest( kDstWidth, kDstHeight );
+			dest.clear();
+
+			copy_rect( dest, dstX, dstY, source, rect );
+
+			for( int y = 0; y < kDstHeight; ++y )
+			{
+				for( int x = 0; x < kDstWidth; ++x )
+				{
+					int const sx = x - dstX + rect.x0;
+					int const sy = y - dstY + rect.y0;
+					bool const copied = sx >= std::max( rect.x0, 0 ) && sx < std::min( rect.x1, kSrcWidth )
+						&& sy >= std::max( rect.y0, 0 ) && sy < std::min( rect.y1, kSrcHeight )
+					;
+
+					INFO( "rect " << i << ", pixel " << x << ", " << y );
+					REQUIRE( (copied ? pixel_( source, sx, sy ) : 0u) == pixel_( dest, x, y ) );
+				}
+			}
+		}
+
+		else
+		{
+			// Source and destination may overlap. The result must be as if
+			// the source was copied to a temporary first.
+			Surface surface( kSrcWidth, kSrcHeight );
+			fill_pattern_( surface, 0x5a5a5au );
+
+			copy_rect( surface, dstX, dstY, surface, rect );
+
+			for( int y = 0; y < kSrcHeight; ++y )
+			{
+				for( int x = 0; x < kSrcWidth; ++x )
+				{
+					int const sx = x - dstX + rect.x0;
+					int const sy = y - dstY + rect.y0;
+					bool const copied = sx >= std::max( rect.x0, 0 ) && sx < std::min( rect.x1, kSrcWidth )
+						&& sy >= std::max( rect.y0, 0 ) && sy < std::min( rect.y1, kSrcHeight )
+					;
+
+					INFO( "rect " << i << ", pixel " << x << ", " << y );
+					REQUIRE( pixel_( source, copied ? sx : x, copied ? sy : y ) == pixel_( surface, x, y ) );
+				}
+			}
+		}
+	}
+
+	set_store_mode( EStoreMode::automatic );
+	set_simd_level_limit( ESimdLevel::avx2 );
+}